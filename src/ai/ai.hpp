@@ -41,6 +41,12 @@ public:
 	 */
 	static uint GetTick();
 
+	/**
+	 * Get the number of script operations the AIs executed in the current tick.
+	 * @return The number of operations, for the tick operations budget.
+	 */
+	static uint64_t GetTickOps();
+
 	/**
 	 * Stop a company to be controlled by an AI.
 	 * @param company The company from which the AI needs to detach.
@@ -140,6 +146,8 @@ public:
 	static bool HasAILibrary(const ContentInfo *ci, bool md5sum);
 private:
 	static uint frame_counter;                      ///< Tick counter for the AI code
+	static CompanyID first_company;                 ///< Company to start the AI loop from, when AIs were deferred due to the tick operations budget
+	static uint64_t tick_ops;                       ///< Script operations executed by the AIs in the current tick
 	static class AIScannerInfo *scanner_info;       ///< ScriptScanner instance that is used to find AIs
 	static class AIScannerLibrary *scanner_library; ///< ScriptScanner instance that is used to find AI Libraries
 };
@@ -17,6 +17,7 @@
 #include "../framerate_type.h"
 #include "../scope_info.h"
 #include "../string_func.h"
+#include "../game/game.hpp"
 #include "ai_scanner.hpp"
 #include "ai_instance.hpp"
 #include "ai_config.hpp"
@@ -26,6 +27,8 @@
 #include "../safeguards.h"
 
 /* static */ uint AI::frame_counter = 0;
+/* static */ CompanyID AI::first_company = COMPANY_FIRST;
+/* static */ uint64_t AI::tick_ops = 0;
 /* static */ AIScannerInfo *AI::scanner_info = nullptr;
 /* static */ AIScannerLibrary *AI::scanner_library = nullptr;
 
@@ -76,6 +79,8 @@
 
 /* static */ void AI::GameLoop()
 {
+	AI::tick_ops = 0;
+
 	/* If we are in networking, only servers run this function, and that only if it is allowed */
 	if (_networking && (!_network_server || !_settings_game.ai.ai_in_multiplayer)) return;
 
@@ -84,20 +89,49 @@
 	assert(_settings_game.difficulty.competitor_speed <= 4);
 	if ((AI::frame_counter & ((1 << (4 - _settings_game.difficulty.competitor_speed)) - 1)) != 0) return;
 
+	/* With an operations budget, AIs which do not fit into this tick are deferred and run first next time.
+	 * A game script which was deferred by the budget gets the whole of this tick, so all AIs are deferred.
+	 * This only depends on the operations the scripts executed, so the result is the same on every machine. */
+	const uint32_t budget = _settings_game.script.script_tick_ops_budget;
+	const bool defer_all = budget > 0 && Game::IsDeferred();
+	const CompanyID start = AI::first_company;
+	AI::first_company = COMPANY_FIRST;
+
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
-	for (const Company *c : Company::Iterate()) {
-		if (c->is_ai) {
-			SCOPE_INFO_FMT([&], "AI::GameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName().c_str(), c->ai_info->GetVersion());
-			PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
-			cur_company.Change(c->index);
-			c->ai_instance->GameLoop();
-			/* Occasionally collect garbage; every 255 ticks do one company.
-			 * Effectively collecting garbage once every two months per AI. */
-			if ((AI::frame_counter & 255) == 0 && (CompanyID)GB(AI::frame_counter, 8, 4) == c->index) {
-				c->ai_instance->CollectGarbage();
-			}
-		} else {
+	bool deferring = false;
+	for (uint i = 0; i < MAX_COMPANIES; i++) {
+		const CompanyID cid = (CompanyID)((start + i) % MAX_COMPANIES);
+		const Company *c = Company::GetIfValid(cid);
+		if (c == nullptr) continue;
+		if (!c->is_ai) {
 			PerformanceMeasurer::SetInactive((PerformanceElement)(PFE_AI0 + c->index));
+			continue;
+		}
+		if (!deferring && budget > 0 && (defer_all || AI::tick_ops >= budget)) {
+			AI::first_company = cid;
+			deferring = true;
+		}
+		if (deferring) {
+			PerformanceMeasurer::Paused((PerformanceElement)(PFE_AI0 + c->index));
+			continue;
+		}
+
+		SCOPE_INFO_FMT([&], "AI::GameLoop: %i: %s (v%d)\n", (int)c->index, c->ai_info->GetName().c_str(), c->ai_info->GetVersion());
+		PerformanceMeasurer framerate((PerformanceElement)(PFE_AI0 + c->index));
+		cur_company.Change(c->index);
+		const uint64_t ops_before = c->ai_instance->GetExecutedOps();
+		c->ai_instance->GameLoop();
+		const uint64_t ops_after = c->ai_instance->GetExecutedOps();
+		if (ops_after > ops_before) AI::tick_ops += ops_after - ops_before;
+	}
+
+	/* Occasionally collect garbage; every 255 ticks do one company.
+	 * Effectively collecting garbage once every two months per AI, whether or not it was deferred. */
+	if ((AI::frame_counter & 255) == 0) {
+		const Company *c = Company::GetIfValid((CompanyID)GB(AI::frame_counter, 8, 4));
+		if (c != nullptr && c->is_ai) {
+			cur_company.Change(c->index);
+			c->ai_instance->CollectGarbage();
 		}
 	}
 	cur_company.Restore();
@@ -108,6 +142,11 @@
 	return AI::frame_counter;
 }
 
+/* static */ uint64_t AI::GetTickOps()
+{
+	return AI::tick_ops;
+}
+
 /* static */ void AI::Stop(CompanyID company)
 {
 	if (_networking && !_network_server) return;
@@ -172,6 +211,8 @@
 	if (AI::scanner_info != nullptr) AI::Uninitialize(true);
 
 	AI::frame_counter = 0;
+	AI::first_company = COMPANY_FIRST;
+	AI::tick_ops = 0;
 	if (AI::scanner_info == nullptr) {
 		TarScanner::DoScan(TarScanner::AI);
 		AI::scanner_info = new AIScannerInfo();
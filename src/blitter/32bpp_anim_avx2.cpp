@@ -0,0 +1,95 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file 32bpp_anim_avx2.cpp Implementation of the AVX2 32 bpp blitter with animation support. */
+
+#ifdef WITH_SSE
+
+#include "../stdafx.h"
+#include "../video/video_driver.hpp"
+#include "../cpu.h"
+#include "32bpp_anim_avx2.hpp"
+#include "32bpp_sse_func.hpp"
+
+#include "../safeguards.h"
+
+/** Instantiation of the AVX2 32bpp blitter with animation factory. */
+static FBlitter_32bppAVX2_Anim iFBlitter_32bppAVX2_Anim;
+
+GNU_TARGET("avx2")
+void Blitter_32bppAVX2_Anim::PaletteAnimate(const Palette &palette)
+{
+	assert(!_screen_disable_anim);
+
+	this->palette = palette;
+	/* If first_dirty is 0, it is for 8bpp indication to send the new
+	 *  palette. However, only the animation colours might possibly change.
+	 *  Especially when going between toyland and non-toyland. */
+	assert(this->palette.first_dirty == PALETTE_ANIM_START || this->palette.first_dirty == 0);
+
+	const uint16_t *anim = this->anim_buf;
+	Colour *dst = (Colour *)_screen.dst_ptr;
+
+	bool screen_dirty = false;
+
+	/* Let's walk the anim buffer and try to find the pixels, 16 at a time */
+	const int width = this->anim_buf_width;
+	const int screen_pitch = _screen.pitch;
+	const int anim_pitch = this->anim_buf_pitch;
+	const __m256i anim_cmp = _mm256_set1_epi16(PALETTE_ANIM_START - 1);
+	const __m256i brightness_cmp = _mm256_set1_epi16(Blitter_32bppBase::DEFAULT_BRIGHTNESS);
+	const __m256i colour_mask = _mm256_set1_epi16(0xFF);
+	for (int y = this->anim_buf_height; y != 0 ; y--) {
+		Colour *next_dst_ln = dst + screen_pitch;
+		const uint16_t *next_anim_ln = anim + anim_pitch;
+		int x = width;
+		for (; x >= 16; x -= 16) {
+			__m256i data = _mm256_loadu_si256((const __m256i *) anim);
+			__m256i colour_data = _mm256_and_si256(data, colour_mask);
+
+			/* test if any colour >= PALETTE_ANIM_START */
+			uint colour_cmp_result = (uint)_mm256_movemask_epi8(_mm256_cmpgt_epi16(colour_data, anim_cmp));
+			if (unlikely(colour_cmp_result != 0)) {
+				if (colour_cmp_result == 0xFFFFFFFF && (uint)_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_srli_epi16(data, 8), brightness_cmp)) == 0xFFFFFFFF) {
+					/* medium path: 16 pixels to animate all of expected brightnesses */
+					for (int z = 0; z < 16; z++) {
+						dst[z] = LookupColourInPalette(GB(anim[z], 0, 8));
+					}
+				} else {
+					/* slow path: some pixels not animated or unexpected brightnesses */
+					for (int z = 0; z < 16; z++) {
+						uint8_t colour = GB(anim[z], 0, 8);
+						if (colour >= PALETTE_ANIM_START) {
+							dst[z] = AdjustBrightneSSE(LookupColourInPalette(colour), GB(anim[z], 8, 8));
+						}
+					}
+				}
+				screen_dirty = true;
+			}
+			anim += 16;
+			dst += 16;
+		}
+		for (; x > 0; x--) {
+			uint8_t colour = GB(*anim, 0, 8);
+			if (colour >= PALETTE_ANIM_START) {
+				*dst = AdjustBrightneSSE(LookupColourInPalette(colour), GB(*anim, 8, 8));
+				screen_dirty = true;
+			}
+			anim++;
+			dst++;
+		}
+		dst = next_dst_ln;
+		anim = next_anim_ln;
+	}
+
+	if (screen_dirty) {
+		/* Make sure the backend redraws the whole screen */
+		VideoDriver::GetInstance()->MakeDirty(0, 0, _screen.width, _screen.height);
+	}
+}
+
+#endif /* WITH_SSE */
@@ -13,7 +13,7 @@
 #ifdef WITH_SSE
 
 GNU_TARGET(SSE_TARGET)
-inline void InsertFirstUint32(const uint32_t value, __m128i &into)
+static inline void InsertFirstUint32(const uint32_t value, __m128i &into)
 {
 #if (SSE_VERSION >= 4)
 	into = _mm_insert_epi32(into, value, 0);
@@ -24,7 +24,7 @@ inline void InsertFirstUint32(const uint32_t value, __m128i &into)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline void InsertSecondUint32(const uint32_t value, __m128i &into)
+static inline void InsertSecondUint32(const uint32_t value, __m128i &into)
 {
 #if (SSE_VERSION >= 4)
 	into = _mm_insert_epi32(into, value, 1);
@@ -35,7 +35,7 @@ inline void InsertSecondUint32(const uint32_t value, __m128i &into)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline void LoadUint64(const uint64_t value, __m128i &into)
+static inline void LoadUint64(const uint64_t value, __m128i &into)
 {
 #ifdef POINTER_IS_64BIT
 	into = _mm_cvtsi64_si128(value);
@@ -50,7 +50,7 @@ inline void LoadUint64(const uint64_t value, __m128i &into)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline __m128i PackUnsaturated(__m128i from, const __m128i &mask)
+static inline __m128i PackUnsaturated(__m128i from, const __m128i &mask)
 {
 #if (SSE_VERSION == 2)
 	from = _mm_and_si128(from, mask);    // PAND, wipe high bytes to keep low bytes when packing
@@ -61,7 +61,7 @@ inline __m128i PackUnsaturated(__m128i from, const __m128i &mask)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline __m128i DistributeAlpha(const __m128i from, const __m128i &mask)
+static inline __m128i DistributeAlpha(const __m128i from, const __m128i &mask)
 {
 #if (SSE_VERSION == 2)
 	__m128i alphaAB = _mm_shufflelo_epi16(from, 0x3F); // PSHUFLW, put alpha1 in front of each rgb1
@@ -73,7 +73,7 @@ inline __m128i DistributeAlpha(const __m128i from, const __m128i &mask)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline __m128i AlphaBlendTwoPixels(__m128i src, __m128i dst, const __m128i &distribution_mask, const __m128i &pack_mask, const __m128i &alpha_mask)
+static inline __m128i AlphaBlendTwoPixels(__m128i src, __m128i dst, const __m128i &distribution_mask, const __m128i &pack_mask, const __m128i &alpha_mask)
 {
 	__m128i srcAB = _mm_unpacklo_epi8(src, _mm_setzero_si128());   // PUNPCKLBW, expand each uint8_t into uint16
 	__m128i dstAB = _mm_unpacklo_epi8(dst, _mm_setzero_si128());
@@ -97,7 +97,7 @@ inline __m128i AlphaBlendTwoPixels(__m128i src, __m128i dst, const __m128i &dist
  * rgb = rgb * ((256/4) * 4 - (alpha/4)) / ((256/4) * 4)
  */
 GNU_TARGET(SSE_TARGET)
-inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const __m128i &distribution_mask, const __m128i &tr_nom_base)
+static inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const __m128i &distribution_mask, const __m128i &tr_nom_base)
 {
 	__m128i srcAB = _mm_unpacklo_epi8(src, _mm_setzero_si128());
 	__m128i dstAB = _mm_unpacklo_epi8(dst, _mm_setzero_si128());
@@ -109,6 +109,59 @@ inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const __m128i &distribu
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/* Same as AlphaBlendTwoPixels, for 4 pixels held in 16 bit fields. */
+GNU_TARGET(SSE_TARGET)
+static inline __m256i AlphaBlendFourExpandedPixels(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &alpha_mask)
+{
+	__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, _mm256_setzero_si256());
+	__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);
+	alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+	srcAB = _mm256_sub_epi16(srcAB, dstAB);
+	srcAB = _mm256_mullo_epi16(srcAB, alphaAB);
+	srcAB = _mm256_srli_epi16(srcAB, 8);
+	srcAB = _mm256_add_epi16(srcAB, dstAB);
+
+	alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask);
+	return _mm256_or_si256(srcAB, alphaMaskAB);
+}
+
+/**
+ * Alpha blend 8 pixels, with the same result as AlphaBlendTwoPixels for each pair.
+ * Unpacking and packing operate within each 128 bit lane, so the pixel order is preserved.
+ */
+GNU_TARGET(SSE_TARGET)
+static inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &clear_hi_mask, const __m256i &alpha_mask)
+{
+	__m256i lo = AlphaBlendFourExpandedPixels(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+	__m256i hi = AlphaBlendFourExpandedPixels(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+
+	/* The high bytes of the fields are not cleaned up by the blend, so mask them before the saturating pack. */
+	return _mm256_packus_epi16(_mm256_and_si256(lo, clear_hi_mask), _mm256_and_si256(hi, clear_hi_mask));
+}
+
+/* Same as DarkenTwoPixels, for 4 pixels held in 16 bit fields. */
+GNU_TARGET(SSE_TARGET)
+static inline __m256i DarkenFourExpandedPixels(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i alphaAB = _mm256_shuffle_epi8(srcAB, distribution_mask);
+	alphaAB = _mm256_srli_epi16(alphaAB, 2);
+	__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaAB);
+	dstAB = _mm256_mullo_epi16(dstAB, nom);
+	return _mm256_srli_epi16(dstAB, 8);
+}
+
+/** Darken 8 pixels, with the same result as DarkenTwoPixels for each pair. */
+GNU_TARGET(SSE_TARGET)
+static inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i lo = DarkenFourExpandedPixels(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, tr_nom_base);
+	__m256i hi = DarkenFourExpandedPixels(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, tr_nom_base);
+	return _mm256_packus_epi16(lo, hi);
+}
+#endif
+
 IGNORE_UNINITIALIZED_WARNING_START
 GNU_TARGET(SSE_TARGET)
 static Colour ReallyAdjustBrightness(Colour colour, uint8_t brightness)
@@ -145,7 +198,7 @@ IGNORE_UNINITIALIZED_WARNING_STOP
 /** ReallyAdjustBrightness() is not called that often.
  * Inlining this function implies a far jump, which has a huge latency.
  */
-inline Colour AdjustBrightneSSE(Colour colour, uint8_t brightness)
+static inline Colour AdjustBrightneSSE(Colour colour, uint8_t brightness)
 {
 	/* Shortcut for normal brightness. */
 	if (likely(brightness == Blitter_32bppBase::DEFAULT_BRIGHTNESS)) return colour;
@@ -154,7 +207,7 @@ inline Colour AdjustBrightneSSE(Colour colour, uint8_t brightness)
 }
 
 GNU_TARGET(SSE_TARGET)
-inline __m128i AdjustBrightnessOfTwoPixels([[maybe_unused]] __m128i from, [[maybe_unused]] uint32_t brightness)
+static inline __m128i AdjustBrightnessOfTwoPixels([[maybe_unused]] __m128i from, [[maybe_unused]] uint32_t brightness)
 {
 #if (SSE_VERSION < 3)
 	NOT_REACHED();
@@ -212,6 +265,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const byte * const remap = bp->remap;
@@ -254,6 +309,14 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_256        = _mm256_broadcastsi128_si256(ALPHA_CONTROL_MASK);
+	const __m256i clear_hi_256    = _mm256_broadcastsi128_si256(CLEAR_HIGH_BYTE_MASK);
+	const __m256i alpha_and_256   = _mm256_broadcastsi128_si256(ALPHA_AND_MASK);
+	const __m256i tr_nom_base_256 = _mm256_broadcastsi128_si256(TRANSPARENT_NOM_BASE);
+	const __m256i alpha_only_256  = _mm256_set1_epi32(0xFF000000);
+	const __m128i mv_m_mask       = _mm_set1_epi16(0x00FF);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -276,7 +339,18 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 		switch (mode) {
 			default:
 				if (!translucent) {
-					for (uint x = (uint) effective_width; x > 0; x--) {
+					uint x = (uint) effective_width;
+#if (SSE_VERSION >= 5)
+					for (; x >= 8; x -= 8) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						__m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(srcABCD, alpha_only_256), _mm256_setzero_si256());
+						_mm256_storeu_si256((__m256i*) dst, _mm256_blendv_epi8(srcABCD, dstABCD, transparent));
+						src += 8;
+						dst += 8;
+					}
+#endif
+					for (; x > 0; x--) {
 						if (src->a) *dst = *src;
 						src++;
 						dst++;
@@ -284,12 +358,24 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
-				for (uint x = (uint) effective_width / 2; x > 0; x--) {
-					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
-					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
-					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
-					src += 2;
-					dst += 2;
+				{
+					uint x = (uint) effective_width / 2;
+#if (SSE_VERSION >= 5)
+					for (; x >= 4; x -= 4) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_256, clear_hi_256, alpha_and_256));
+						src += 8;
+						dst += 8;
+					}
+#endif
+					for (; x > 0; x--) {
+						__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
+						__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
+						_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
+						src += 2;
+						dst += 2;
+					}
 				}
 
 				if ((bt_last == BT_NONE && effective_width & 1) || bt_last == BT_ODD) {
@@ -302,6 +388,22 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 			case BM_COLOUR_REMAP:
 #if (SSE_VERSION >= 3)
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 5)
+					if (x >= 4) {
+						/* When none of the next 8 pixels are remapped, blend them all at once. */
+						__m128i mvX8 = _mm_loadu_si128((const __m128i*) src_mv);
+						if (_mm_testz_si128(mvX8, mv_m_mask)) {
+							__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+							__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+							_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_256, clear_hi_256, alpha_and_256));
+							dst += 8;
+							src += 8;
+							src_mv += 8;
+							x -= 3;
+							continue;
+						}
+					}
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					uint32_t mvX2 = *((uint32_t *) const_cast<MapValue *>(src_mv));
@@ -383,12 +485,24 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
-				for (uint x = (uint) bp->width / 2; x > 0; x--) {
-					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
-					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
-					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
-					src += 2;
-					dst += 2;
+				{
+					uint x = (uint) bp->width / 2;
+#if (SSE_VERSION >= 5)
+					for (; x >= 4; x -= 4) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						_mm256_storeu_si256((__m256i *) dst, DarkenEightPixels(srcABCD, dstABCD, a_cm_256, tr_nom_base_256));
+						src += 8;
+						dst += 8;
+					}
+#endif
+					for (; x > 0; x--) {
+						__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
+						__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
+						_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
+						src += 2;
+						dst += 2;
+					}
 				}
 
 				if ((bt_last == BT_NONE && bp->width & 1) || bt_last == BT_ODD) {
@@ -515,6 +629,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -205,9 +205,8 @@ bool StationCargoReroute::operator()(CargoPacket *cp)
 		this->destination->AddToCache(cp_new);
 	}
 
-	/* Legal, as insert doesn't invalidate iterators in the MultiMap, however
-	 * this might insert the packet between range.first and range.second (which might be end())
-	 * This is why we check for GetKey above to avoid infinite loops. */
+	/* This may insert a new next hop into the map, so StationCargoList::ShiftCargo
+	 * must not hold any map iterators across this call. */
 	this->destination->packets.Insert(next, cp_new);
 	return cp_new == cp;
 }
@@ -927,16 +927,18 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 template <class Taction>
 bool StationCargoList::ShiftCargo(Taction &action, StationID next)
 {
-	for (Iterator it = this->packets.lower_bound(next); it != this->packets.end() && it.GetKey() == next;) {
+	for (;;) {
+		StationCargoPacketMap::MapIterator map_it = this->packets.find(next);
+		if (map_it == this->packets.Map::end()) return true;
 		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
-		if (action(cp)) {
-			it = this->packets.erase(it);
-		} else {
-			return false;
-		}
+		CargoPacket *cp = map_it->second.front();
+		if (!action(cp)) return false;
+
+		/* The action may have inserted into this map (e.g. rerouting to this list), which invalidates map_it. */
+		map_it = this->packets.find(next);
+		map_it->second.pop_front();
+		if (map_it->second.empty()) this->packets.Map::erase(map_it);
 	}
-	return true;
 }
 
 /**
@@ -983,20 +985,23 @@ uint StationCargoList::ShiftCargo(Taction action, StationIDStack next, bool incl
 template <class Taction>
 bool StationCargoList::ShiftCargoFromSource(Taction &action, StationID source, StationID next)
 {
-	for (Iterator it = this->packets.lower_bound(next); it != this->packets.end() && it.GetKey() == next;) {
+	size_t pos = 0;
+	for (;;) {
+		StationCargoPacketMap::MapIterator map_it = this->packets.find(next);
+		if (map_it == this->packets.Map::end() || pos >= map_it->second.size()) return true;
 		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
+		CargoPacket *cp = map_it->second[pos];
 		if (cp->GetFirstStation() != source) {
-			++it;
+			++pos;
 			continue;
 		}
-		if (action(cp)) {
-			it = this->packets.erase(it);
-		} else {
-			return false;
-		}
+		if (!action(cp)) return false;
+
+		/* The action may have inserted into this map (e.g. rerouting to this list), which invalidates map_it. */
+		map_it = this->packets.find(next);
+		map_it->second.erase(map_it->second.begin() + pos);
+		if (map_it->second.empty()) this->packets.Map::erase(map_it);
 	}
-	return true;
 }
 
 /**
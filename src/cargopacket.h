@@ -18,6 +18,7 @@
 #include "vehicle_type.h"
 #include "company_type.h"
 #include "core/multimap.hpp"
+#include "core/flat_map.hpp"
 #include "sl/saveload_common.h"
 #include "core/ring_buffer.hpp"
 #include "3rdparty/cpp-btree/btree_map.h"
@@ -565,7 +566,11 @@ public:
 	}
 };
 
-typedef MultiMap<StationID, CargoPacket *, CargoPacketList> StationCargoPacketMap;
+/**
+ * Station cargo packets, grouped by next hop.
+ * Most goods entries only have a handful of next hops, so these are kept in a flat map with inline storage.
+ */
+typedef MultiMap<StationID, CargoPacket *, CargoPacketList, std::less<StationID>, flat_map<StationID, CargoPacketList, 4>> StationCargoPacketMap;
 typedef btree::btree_map<StationID, uint> StationCargoAmountMap;
 
 /**
@@ -96,6 +96,7 @@ inline void AddClearDensity(TileIndex t, int d)
 {
 	dbg_assert_tile(IsTileType(t, MP_CLEAR), t); // XXX incomplete
 	_m[t].m5 += d;
+	WakeTileLoopTile(t);
 }
 
 /**
@@ -108,6 +109,7 @@ inline void SetClearDensity(TileIndex t, uint d)
 {
 	dbg_assert_tile(IsTileType(t, MP_CLEAR), t);
 	SB(_m[t].m5, 0, 2, d);
+	WakeTileLoopTile(t);
 }
 
 
@@ -159,6 +161,7 @@ inline void SetClearGroundDensity(TileIndex t, ClearGround type, uint density)
 {
 	dbg_assert_tile(IsTileType(t, MP_CLEAR), t); // XXX incomplete
 	_m[t].m5 = 0 << 5 | type << 2 | density;
+	WakeTileLoopTile(t);
 }
 
 
@@ -301,6 +304,7 @@ inline void MakeSnow(TileIndex t, uint density = 0)
 {
 	dbg_assert_tile(GetClearGround(t) != CLEAR_SNOW, t);
 	SetBit(_m[t].m3, 4);
+	WakeTileLoopTile(t);
 	if (GetRawClearGround(t) == CLEAR_FIELDS) {
 		SetClearGroundDensity(t, CLEAR_GRASS, density);
 	} else {
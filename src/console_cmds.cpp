@@ -1843,6 +1843,65 @@ DEF_CONSOLE_CMD(ConMinimap)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConExportMapTiles)
+{
+	if (argc == 0) {
+		IConsoleHelp("Export the map as a pyramid of 256x256 tile images for a web map. Usage: 'export_map_tiles [minimap | topography | industry] [full] [<name>]'");
+		IConsoleHelp("  The images are written to <name>/<zoom>/<x>/<y>.png in the screenshot directory, <name> defaults to 'map_tiles'.");
+		IConsoleHelp("  The most detailed zoom level uses one pixel per tile, zoom level 0 fits the whole map in one image.");
+		IConsoleHelp("  Only images whose map area has changed since the last export of this game to the same directory are written again.");
+		IConsoleHelp("  'minimap' (default), 'topography' and 'industry' select the colouring, as for the screenshot command.");
+		IConsoleHelp("  'full' writes all images.");
+		return true;
+	}
+
+	if (argc > 4) return false;
+
+	ScreenshotType type = SC_MINIMAP;
+	bool full = false;
+	const char *name = "map_tiles";
+	uint32_t arg_index = 1;
+
+	if (argc > arg_index) {
+		if (strcmp(argv[arg_index], "minimap") == 0) {
+			type = SC_MINIMAP;
+			arg_index += 1;
+		} else if (strcmp(argv[arg_index], "topography") == 0) {
+			type = SC_TOPOGRAPHY;
+			arg_index += 1;
+		} else if (strcmp(argv[arg_index], "industry") == 0) {
+			type = SC_INDUSTRY;
+			arg_index += 1;
+		}
+	}
+
+	if (argc > arg_index && strcmp(argv[arg_index], "full") == 0) {
+		full = true;
+		arg_index += 1;
+	}
+
+	if (argc > arg_index) {
+		name = argv[arg_index];
+		arg_index += 1;
+	}
+
+	if (argc > arg_index) return false;
+
+	/* The name may come from the admin port, so do not allow it to refer to anywhere outside the screenshot directory. */
+	if (*name == '\0' || strspn(name, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.") != strlen(name) || strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+		IConsoleError("Directory name may only contain letters, digits, '_', '-' and '.'.");
+		return true;
+	}
+
+	uint written;
+	if (ExportMapTiles(name, type, full, written)) {
+		IConsolePrintF(CC_DEFAULT, "Exported %u map tile images to '%s'.", written, name);
+	} else {
+		IConsolePrintF(CC_ERROR, "Map tile export to '%s' failed, %u images were written.", name, written);
+	}
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConInfoCmd)
 {
 	if (argc == 0) {
@@ -3175,6 +3234,32 @@ DEF_CONSOLE_CMD(ConDumpTile)
 	return false;
 }
 
+DEF_CONSOLE_CMD(ConDumpNewGRFLoadTimes)
+{
+	if (argc == 0) {
+		IConsoleHelp("Dump the time taken to load each NewGRF, in milliseconds.");
+		return true;
+	}
+
+	auto ms = [](uint32_t us) { return us / 1000.0; };
+	double total_read_ahead = 0;
+	double total_stages = 0;
+	for (const GRFFile *grf : GetAllGRFFiles()) {
+		double stages = 0;
+		for (GrfLoadingStage stage = GLS_LABELSCAN; stage < GLS_END; stage++) stages += ms(grf->load_stage_time[stage]);
+		total_read_ahead += ms(grf->read_ahead_time);
+		total_stages += stages;
+
+		IConsolePrintF(CC_DEFAULT, "[%08X] %s: read ahead%s: %.2f, label scan: %.2f, init: %.2f, reserve: %.2f, activation: %.2f, total: %.2f",
+				BSWAP32(grf->grfid), grf->filename.c_str(), grf->read_ahead_from_cache ? " (cached)" : "", ms(grf->read_ahead_time), ms(grf->load_stage_time[GLS_LABELSCAN]),
+				ms(grf->load_stage_time[GLS_INIT]), ms(grf->load_stage_time[GLS_RESERVE]), ms(grf->load_stage_time[GLS_ACTIVATION]), stages);
+	}
+	IConsolePrintF(CC_DEFAULT, "%u NewGRFs, read ahead (on worker threads): %.2f, loading stages: %.2f",
+			(uint)GetAllGRFFiles().size(), total_read_ahead, total_stages);
+
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConDumpGrfCargoTables)
 {
 	if (argc == 0) {
@@ -3456,6 +3541,32 @@ DEF_CONSOLE_CMD(ConGfxDebug)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConRedrawStats)
+{
+	if (argc < 1 || argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		IConsoleHelp("Debug: show statistics of the screen areas redrawn per frame.  Usage: 'redraw_stats [reset]'");
+		return true;
+	}
+
+	if (argc == 2) {
+		_redraw_stats.total = {};
+		return true;
+	}
+
+	auto print_stats = [](const char *name, const RedrawStats &stats, uint64_t frames) {
+		frames = std::max<uint64_t>(1, frames);
+		IConsolePrintF(CC_DEFAULT, "%s: %u whole screen, %u rects (%u px), %u windows, %u widgets, %u window paints (%u px), viewports: %u px", name,
+				(uint)(stats.whole_screen / frames), (uint)(stats.dirty_rects / frames), (uint)(stats.dirty_rect_pixels / frames),
+				(uint)(stats.window_redraws / frames), (uint)(stats.widget_redraws / frames), (uint)(stats.window_paints / frames),
+				(uint)(stats.window_pixels / frames), (uint)(stats.viewport_pixels / frames));
+	};
+	print_stats("Last frame", _redraw_stats.last_frame, 1);
+	IConsolePrintF(CC_DEFAULT, "Frames since reset: " OTTD_PRINTF64U, _redraw_stats.total.frames);
+	print_stats("Average per frame", _redraw_stats.total, _redraw_stats.total.frames);
+
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConCSleep)
 {
 	if (argc != 2) {
@@ -3960,6 +4071,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("return",                  ConReturn);
 	IConsole::CmdRegister("screenshot",              ConScreenShot);
 	IConsole::CmdRegister("minimap",                 ConMinimap);
+	IConsole::CmdRegister("export_map_tiles",        ConExportMapTiles);
 	IConsole::CmdRegister("script",                  ConScript);
 	IConsole::CmdRegister("zoomto",                  ConZoomToLevel);
 	IConsole::CmdRegister("scrollto",                ConScrollToTile);
@@ -4116,6 +4228,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("dump_vehicle",            ConDumpVehicle,      nullptr, true);
 	IConsole::CmdRegister("dump_tile",               ConDumpTile,         nullptr, true);
 	IConsole::CmdRegister("dump_grf_cargo_tables",   ConDumpGrfCargoTables, nullptr, true);
+	IConsole::CmdRegister("dump_newgrf_load_times",  ConDumpNewGRFLoadTimes, nullptr, true);
 	IConsole::CmdRegister("dump_signal_styles",      ConDumpSignalStyles, nullptr, true);
 	IConsole::CmdRegister("dump_sprite_cache_stats", ConSpriteCacheStats, nullptr, true);
 	IConsole::CmdRegister("dump_version",            ConDumpVersion,      nullptr, true);
@@ -4127,6 +4240,7 @@ void IConsoleStdLibRegister()
 	IConsole::CmdRegister("viewport_mark_dirty",     ConViewportMarkDirty, nullptr, true);
 	IConsole::CmdRegister("viewport_mark_dirty_st_overlay", ConViewportMarkStationOverlayDirty, nullptr, true);
 	IConsole::CmdRegister("gfx_debug",               ConGfxDebug,         nullptr, true);
+	IConsole::CmdRegister("redraw_stats",            ConRedrawStats,      nullptr, true);
 	IConsole::CmdRegister("csleep",                  ConCSleep,           nullptr, true);
 	IConsole::CmdRegister("recalculate_road_cached_one_way_states", ConRecalculateRoadCachedOneWayStates, ConHookNoNetwork, true);
 	IConsole::CmdRegister("misc_debug",              ConMiscDebug,        nullptr, true);
@@ -0,0 +1,268 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flat_map.hpp Sorted vector map with inline storage for a small number of items. */
+
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include "alloc_func.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/**
+ * Map stored as a sorted contiguous array of key/value pairs.
+ *
+ * Up to N items are stored inline without any heap allocation, beyond that the items are moved to a heap buffer.
+ * Lookup is a binary search over the contiguous array, which for the small number of keys this is intended for
+ * is considerably cheaper than walking the nodes of a std::map.
+ *
+ * Insertion or erasure of an item invalidates existing iterators and references to items after the insertion/erasure point,
+ * insertion may also invalidate all existing iterators and references if the storage is reallocated.
+ * This is unlike std::map, users which rely on iterator stability must look up the item again after modifying the map.
+ *
+ * Values are moved around when the map is modified, they must be nothrow move constructible and assignable.
+ */
+template <typename Tkey, typename Tvalue, uint N = 4, typename Tcompare = std::less<Tkey>>
+class flat_map
+{
+public:
+	using key_type = Tkey;
+	using mapped_type = Tvalue;
+	using value_type = std::pair<Tkey, Tvalue>;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using key_compare = Tcompare;
+	using reference = value_type &;
+	using const_reference = const value_type &;
+	using iterator = value_type *;
+	using const_iterator = const value_type *;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	static_assert(N > 0);
+	static_assert(std::is_nothrow_move_constructible_v<value_type>);
+	static_assert(std::is_nothrow_move_assignable_v<value_type>);
+
+private:
+	value_type *items;    ///< Items, this is either inline_storage or a heap buffer.
+	uint32_t count = 0;   ///< Number of items in use.
+	uint32_t cap = N;     ///< Capacity of items.
+	alignas(value_type) byte inline_storage[N * sizeof(value_type)];
+
+	value_type *inline_items() { return reinterpret_cast<value_type *>(this->inline_storage); }
+
+	bool is_inline() const { return this->cap == N; }
+
+	/** Destroy all items and free any heap buffer, leaving the map empty with inline storage. */
+	void reset()
+	{
+		std::destroy_n(this->items, this->count);
+		if (!this->is_inline()) free(this->items);
+		this->items = this->inline_items();
+		this->count = 0;
+		this->cap = N;
+	}
+
+	/** Take the contents of other, which is left empty. This map must be empty and using inline storage. */
+	void steal(flat_map &other) noexcept
+	{
+		if (other.is_inline()) {
+			std::uninitialized_move_n(other.items, other.count, this->items);
+			std::destroy_n(other.items, other.count);
+		} else {
+			this->items = other.items;
+			this->cap = other.cap;
+			other.items = other.inline_items();
+			other.cap = N;
+		}
+		this->count = other.count;
+		other.count = 0;
+	}
+
+	/**
+	 * Make space for one new item at the given position.
+	 * @param pos Index to insert at.
+	 * @return Pointer to uninitialised storage at the given index.
+	 */
+	value_type *make_gap(uint32_t pos)
+	{
+		if (this->count == this->cap) {
+			uint32_t new_cap = this->cap * 2;
+			value_type *new_items = MallocT<value_type>(new_cap);
+			std::uninitialized_move_n(this->items, pos, new_items);
+			std::uninitialized_move_n(this->items + pos, this->count - pos, new_items + pos + 1);
+			std::destroy_n(this->items, this->count);
+			if (!this->is_inline()) free(this->items);
+			this->items = new_items;
+			this->cap = new_cap;
+		} else if (pos < this->count) {
+			value_type *last = this->items + this->count;
+			new (last) value_type(std::move(*(last - 1)));
+			std::move_backward(this->items + pos, last - 1, last);
+			std::destroy_at(this->items + pos);
+		}
+		this->count++;
+		return this->items + pos;
+	}
+
+public:
+	flat_map() : items(inline_items()) {}
+
+	flat_map(const flat_map &other) : flat_map()
+	{
+		*this = other;
+	}
+
+	flat_map(flat_map &&other) noexcept : flat_map()
+	{
+		this->steal(other);
+	}
+
+	~flat_map()
+	{
+		this->reset();
+	}
+
+	flat_map &operator=(const flat_map &other)
+	{
+		if (&other != this) {
+			this->reset();
+			if (other.count > N) {
+				this->items = MallocT<value_type>(other.cap);
+				this->cap = other.cap;
+			}
+			std::uninitialized_copy_n(other.items, other.count, this->items);
+			this->count = other.count;
+		}
+		return *this;
+	}
+
+	flat_map &operator=(flat_map &&other) noexcept
+	{
+		if (&other != this) {
+			this->reset();
+			this->steal(other);
+		}
+		return *this;
+	}
+
+	bool operator==(const flat_map &other) const
+	{
+		return std::equal(this->begin(), this->end(), other.begin(), other.end());
+	}
+
+	iterator begin() { return this->items; }
+	const_iterator begin() const { return this->items; }
+	const_iterator cbegin() const { return this->items; }
+	iterator end() { return this->items + this->count; }
+	const_iterator end() const { return this->items + this->count; }
+	const_iterator cend() const { return this->items + this->count; }
+
+	reverse_iterator rbegin() { return reverse_iterator(this->end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(this->end()); }
+	reverse_iterator rend() { return reverse_iterator(this->begin()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(this->begin()); }
+
+	bool empty() const { return this->count == 0; }
+	size_type size() const { return this->count; }
+	size_type capacity() const { return this->cap; }
+
+	void clear()
+	{
+		this->reset();
+	}
+
+	iterator lower_bound(const Tkey &key)
+	{
+		return std::lower_bound(this->begin(), this->end(), key, [](const value_type &item, const Tkey &k) { return Tcompare()(item.first, k); });
+	}
+
+	const_iterator lower_bound(const Tkey &key) const
+	{
+		return std::lower_bound(this->begin(), this->end(), key, [](const value_type &item, const Tkey &k) { return Tcompare()(item.first, k); });
+	}
+
+	iterator upper_bound(const Tkey &key)
+	{
+		return std::upper_bound(this->begin(), this->end(), key, [](const Tkey &k, const value_type &item) { return Tcompare()(k, item.first); });
+	}
+
+	const_iterator upper_bound(const Tkey &key) const
+	{
+		return std::upper_bound(this->begin(), this->end(), key, [](const Tkey &k, const value_type &item) { return Tcompare()(k, item.first); });
+	}
+
+	iterator find(const Tkey &key)
+	{
+		iterator it = this->lower_bound(key);
+		return (it != this->end() && !Tcompare()(key, it->first)) ? it : this->end();
+	}
+
+	const_iterator find(const Tkey &key) const
+	{
+		const_iterator it = this->lower_bound(key);
+		return (it != this->end() && !Tcompare()(key, it->first)) ? it : this->end();
+	}
+
+	bool contains(const Tkey &key) const
+	{
+		return this->find(key) != this->end();
+	}
+
+	/**
+	 * Insert a default-constructed value for key if it is not already present.
+	 * @param key Key to insert.
+	 * @return Pair of iterator to the item with the given key, and whether it was inserted.
+	 */
+	std::pair<iterator, bool> try_emplace(const Tkey &key)
+	{
+		iterator it = this->lower_bound(key);
+		if (it != this->end() && !Tcompare()(key, it->first)) return { it, false };
+		value_type *item = this->make_gap((uint32_t)(it - this->begin()));
+		new (item) value_type(key, Tvalue());
+		return { item, true };
+	}
+
+	Tvalue &operator[](const Tkey &key)
+	{
+		return this->try_emplace(key).first->second;
+	}
+
+	/**
+	 * Erase the item pointed to by an iterator.
+	 * @param pos Item to erase.
+	 * @return Iterator to the item after the erased one.
+	 */
+	iterator erase(const_iterator pos)
+	{
+		iterator it = this->begin() + (pos - this->cbegin());
+		std::move(it + 1, this->end(), it);
+		this->count--;
+		std::destroy_at(this->items + this->count);
+		return it;
+	}
+
+	/**
+	 * Erase the item with the given key, if present.
+	 * @param key Key to erase.
+	 * @return Number of items erased.
+	 */
+	size_type erase(const Tkey &key)
+	{
+		iterator it = this->find(key);
+		if (it == this->end()) return 0;
+		this->erase(it);
+		return 1;
+	}
+};
+
+#endif /* FLAT_MAP_HPP */
@@ -13,7 +13,7 @@
 #include <map>
 #include <list>
 
-template<typename Tkey, typename Tvalue, typename Tcontainer, typename Tcompare>
+template<typename Tkey, typename Tvalue, typename Tcontainer, typename Tcompare, typename Tmap>
 class MultiMap;
 
 /**
@@ -28,7 +28,7 @@ class MultiMap;
 template<class Tmap_iter, class Tlist_iter, class Tkey, class Tvalue, class Tcontainer, class Tcompare>
 class MultiMapIterator {
 protected:
-	friend class MultiMap<Tkey, Tvalue, Tcontainer, Tcompare>;
+	template<typename, typename, typename, typename, typename> friend class MultiMap;
 	typedef MultiMapIterator<Tmap_iter, Tlist_iter, Tkey, Tvalue, Tcontainer, Tcompare> Self;
 
 	Tlist_iter list_iter; ///< Iterator pointing to current position in the current list of items with equal keys.
@@ -280,15 +280,17 @@ bool operator!=(const Tmap_iter2 &iter2, const MultiMapIterator<Tmap_iter1, Tlis
  * internally ordered in a deterministic way (contrary to STL multimap). All
  * STL-compatible members are named in STL style, all others are named in OpenTTD
  * style.
+ * The underlying map type can be replaced by a std::map compatible container such
+ * as flat_map, in which case the iterator invalidation rules of that container apply.
  */
-template<typename Tkey, typename Tvalue, typename Tcontainer = std::list<Tvalue>, typename Tcompare = std::less<Tkey> >
-class MultiMap : public std::map<Tkey, Tcontainer, Tcompare > {
+template<typename Tkey, typename Tvalue, typename Tcontainer = std::list<Tvalue>, typename Tcompare = std::less<Tkey>, typename Tmap = std::map<Tkey, Tcontainer, Tcompare>>
+class MultiMap : public Tmap {
 public:
 	typedef Tcontainer List;
 	typedef typename List::iterator ListIterator;
 	typedef typename List::const_iterator ConstListIterator;
 
-	typedef typename std::map<Tkey, List, Tcompare > Map;
+	typedef Tmap Map;
 	typedef typename Map::iterator MapIterator;
 	typedef typename Map::const_iterator ConstMapIterator;
 
@@ -314,7 +316,7 @@ public:
 			}
 		} else {
 			list.erase(list.begin());
-			if (list.empty()) this->Map::erase(it.map_iter++);
+			if (list.empty()) it.map_iter = this->Map::erase(it.map_iter);
 		}
 		return it;
 	}
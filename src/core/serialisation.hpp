@@ -339,4 +339,29 @@ struct BufferSerialiser : public BufferSerialisationHelper<BufferSerialiser> {
 	size_t GetSerialisationLimit() const { return std::numeric_limits<size_t>::max(); }
 };
 
+struct BufferDeserialiser : public BufferDeserialisationHelper<BufferDeserialiser> {
+	const byte *buffer;
+	size_t size;
+	size_t pos = 0;
+	bool error = false;
+
+	BufferDeserialiser(std::span<const byte> buffer) : buffer(buffer.data()), size(buffer.size()) {}
+
+	const byte *GetDeserialisationBuffer() const { return this->buffer; }
+	size_t GetDeserialisationBufferSize() const { return this->size; }
+	size_t &GetDeserialisationPosition() { return this->pos; }
+
+	bool CanDeserialiseBytes(size_t bytes_to_read, bool raise_error)
+	{
+		if (this->error) return false;
+
+		if (this->pos + bytes_to_read > this->size) {
+			if (raise_error) this->error = true;
+			return false;
+		}
+
+		return true;
+	}
+};
+
 #endif /* SERIALISATION_HPP */
@@ -30,7 +30,12 @@
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 void ottd_cpuid(int info[4], int type)
 {
-	__cpuid(info, type);
+	__cpuidex(info, type, 0);
+}
+
+static uint64_t ottd_xgetbv()
+{
+	return _xgetbv(0);
 }
 #elif defined(__x86_64__) || defined(__i386)
 void ottd_cpuid(int info[4], int type)
@@ -50,16 +55,27 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "2" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "2" (0)
 	);
 #endif /* i386 PIC */
 }
+
+static uint64_t ottd_xgetbv()
+{
+	uint32_t eax, edx;
+	__asm__ __volatile__ (
+			"xgetbv          \n\t"
+			: "=a" (eax), "=d" (edx)
+			: "c" (0)
+	);
+	return ((uint64_t)edx << 32) | eax;
+}
 #elif defined(__e2k__) /* MCST Elbrus 2000*/
 void ottd_cpuid(int info[4], int type)
 {
@@ -78,11 +94,21 @@ void ottd_cpuid(int info[4], int type)
 #endif
 	}
 }
+
+static uint64_t ottd_xgetbv()
+{
+	return 0;
+}
 #else
 void ottd_cpuid(int info[4], int)
 {
 	info[0] = info[1] = info[2] = info[3] = 0;
 }
+
+static uint64_t ottd_xgetbv()
+{
+	return 0;
+}
 #endif
 
 bool HasCPUIDFlag(uint type, uint index, uint bit)
@@ -95,3 +121,11 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+bool HasCPUAVX2Support()
+{
+	/* The OS must also save the upper halves of the YMM registers on context switches. */
+	if (!HasCPUIDFlag(1, 2, 27) || !HasCPUIDFlag(1, 2, 28)) return false; // OSXSAVE and AVX
+	if ((ottd_xgetbv() & 0x6) != 0x6) return false; // XMM and YMM state enabled by the OS
+	return HasCPUIDFlag(7, 1, 5); // AVX2
+}
@@ -26,4 +26,10 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether the current CPU and OS support AVX2 instructions.
+ * @return True when AVX2 instructions can be used.
+ */
+bool HasCPUAVX2Support();
+
 #endif /* CPU_H */
@@ -23,6 +23,7 @@ enum ChickenBitFlags {
 	DCBF_CMD_NO_TEST_ALL               = 6,
 	DCBF_WATER_REGION_CLEAR            = 7,
 	DCBF_WATER_REGION_INIT_ALL         = 8,
+	DCBF_TILE_LOOP_SKIP_IDLE           = 9,
 };
 
 inline bool HasChickenBit(ChickenBitFlags flag)
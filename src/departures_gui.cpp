@@ -104,6 +104,7 @@ protected:
 	bool show_freight;         ///< Show freight vehicles
 	bool cargo_buttons_disabled;///< Show pax/freight buttons disabled
 	mutable bool scroll_refresh; ///< Whether the window should be refreshed when paused due to scrolling
+	mutable StateTicks next_redraw_tick; ///< The tick at which the displayed list next changes due to the passing of time
 	uint min_width;            ///< The minimum width of this window.
 	Scrollbar *vscroll;
 	std::vector<const Vehicle *> vehicles; /// current set of vehicles
@@ -240,6 +241,7 @@ public:
 		vehicles_invalid(true),
 		elapsed_ms(0),
 		calc_tick_countdown(0),
+		next_redraw_tick(INVALID_STATE_TICKS),
 		min_width(400)
 	{
 		this->SetupValues();
@@ -480,8 +482,9 @@ public:
 			this->SetWidgetDirty(WID_DB_SHOW_ARRS);
 		}
 
-		/* We need to redraw the scrolling text in its new position. */
-		this->SetWidgetDirty(WID_DB_LIST);
+		/* We need to redraw the scrolling text in its new position, and the list when a departure is due to be shown or to change status.
+		 * Otherwise the list does not change until it is recomputed. */
+		if (this->scroll_refresh || _state_ticks >= this->next_redraw_tick) this->SetWidgetDirty(WID_DB_LIST);
 
 		if (this->vehicles_invalid) {
 			this->RefreshVehicleList();
@@ -750,6 +753,12 @@ void DeparturesWindow<Twaypoint>::DrawDeparturesListItems(const Rect &r) const
 	StateTicks now_date = _state_ticks;
 	StateTicks max_date = now_date + GetDeparturesMaxTicksAhead();
 
+	/* Note the earliest tick at which something drawn here changes only because time has passed. */
+	this->next_redraw_tick = INT64_MAX;
+	auto note_change_at = [&](StateTicks tick) {
+		if (tick > now_date && tick < this->next_redraw_tick) this->next_redraw_tick = tick;
+	};
+
 	/* Draw each departure. */
 	for (uint i = 0; i < max_departures; ++i) {
 		const Departure *d;
@@ -776,6 +785,7 @@ void DeparturesWindow<Twaypoint>::DrawDeparturesListItems(const Rect &r) const
 
 		/* If for some reason the departure is too far in the future or is at a negative time, skip it. */
 		if (d->scheduled_tick > max_date || d->scheduled_tick < 0) {
+			note_change_at(d->scheduled_tick - GetDeparturesMaxTicksAhead());
 			continue;
 		}
 
@@ -935,6 +945,8 @@ void DeparturesWindow<Twaypoint>::DrawDeparturesListItems(const Rect &r) const
 				/* The vehicle has been cancelled. */
 				DrawString(status_left, status_right, y + 1, STR_DEPARTURES_CANCELLED);
 			} else{
+				note_change_at(d->scheduled_tick);
+				note_change_at(d->scheduled_tick + d->lateness + 1);
 				if (d->lateness <= TimetableAbsoluteDisplayUnitSize() && d->scheduled_tick > now_date) {
 					/* We have no evidence that the vehicle is late, so assume it is on time. */
 					DrawString(status_left, status_right, y + 1, STR_DEPARTURES_ON_TIME);
@@ -374,13 +374,50 @@ void FioCreateDirectory(const std::string &name)
 #endif
 }
 
-void FioRenameFile(const std::string &oldname, const std::string &newname)
+/**
+ * Rename a file.
+ * @param oldname The current name of the file.
+ * @param newname The new name of the file.
+ * @return True if the file was renamed.
+ */
+bool FioRenameFile(const std::string &oldname, const std::string &newname)
 {
 #if defined(_WIN32)
-	_wrename(OTTD2FS(oldname).c_str(), OTTD2FS(newname).c_str());
+	return _wrename(OTTD2FS(oldname).c_str(), OTTD2FS(newname).c_str()) == 0;
 #else
-	rename(oldname.c_str(), newname.c_str());
+	return rename(oldname.c_str(), newname.c_str()) == 0;
+#endif
+}
+
+/**
+ * Write a file, replacing the file if it already exists.
+ * The content is written under a temporary name first, so that other instances of the game never read a partial file.
+ * @param filename The name of the file.
+ * @param data The content of the file.
+ * @param size The size of the content.
+ * @return True if the file was written.
+ */
+bool FioReplaceFile(const std::string &filename, const void *data, size_t size)
+{
+	std::string temp_filename = filename + ".tmp";
+	{
+		std::unique_ptr<FILE, FileDeleter> fp(fopen(temp_filename.c_str(), "wb"));
+		if (fp == nullptr) return false;
+		if (fwrite(data, 1, size, fp.get()) != size) {
+			fp.reset();
+			unlink(temp_filename.c_str());
+			return false;
+		}
+	}
+#if defined(_WIN32)
+	/* Renaming does not replace an existing file on Windows. */
+	unlink(filename.c_str());
 #endif
+	if (!FioRenameFile(temp_filename, filename)) {
+		unlink(temp_filename.c_str());
+		return false;
+	}
+	return true;
 }
 
 /**
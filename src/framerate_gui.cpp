@@ -196,6 +196,8 @@ namespace {
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
+		PerformanceData(1),                     // PFE_DRAWWORLD_COLLECT
+		PerformanceData(1),                     // PFE_DRAWWORLD_SORT
 		PerformanceData(60.0),                  // PFE_VIDEO
 		PerformanceData(1000.0 * 8192 / 44100), // PFE_SOUND
 		PerformanceData(1),                     // PFE_ALLSCRIPTS
@@ -225,7 +227,7 @@ namespace {
  * The basis of the timestamp is implementation defined, but the value should be steady,
  * so differences can be taken to reliably measure intervals.
  */
-static TimingMeasurement GetPerformanceTimer()
+TimingMeasurement GetPerformanceTimer()
 {
 	using namespace std::chrono;
 	return (TimingMeasurement)time_point_cast<microseconds>(high_resolution_clock::now()).time_since_epoch().count();
@@ -320,6 +322,17 @@ void PerformanceAccumulator::Reset(PerformanceElement elem)
 	_pf_data[elem].BeginAccumulate(GetPerformanceTimer());
 }
 
+/**
+ * Add a block of time which was measured elsewhere to the accumulating value.
+ * This is for work done on other threads, this must only be called from the main thread.
+ * @param elem The element to add the time to
+ * @param time The time to add, as a difference of GetPerformanceTimer values
+ */
+void PerformanceAccumulator::AddTime(PerformanceElement elem, TimingMeasurement time)
+{
+	_pf_data[elem].AddAccumulate(time);
+}
+
 
 void ShowFrametimeGraphWindow(PerformanceElement elem);
 
@@ -352,6 +365,8 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GL_LINKGRAPH,
 	PFE_DRAWING,
 	PFE_DRAWWORLD,
+	PFE_DRAWWORLD_COLLECT,
+	PFE_DRAWWORLD_SORT,
 	PFE_VIDEO,
 	PFE_SOUND,
 };
@@ -1055,6 +1070,8 @@ void ConPrintFramerate()
 		"  GL link graph delays",
 		"Drawing",
 		"  Viewport drawing",
+		"    Viewport sprite collection",
+		"    Viewport sprite sorting",
 		"Video output",
 		"Sound mixing",
 		"AI/GS scripts total",
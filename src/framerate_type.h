@@ -56,6 +56,8 @@ enum PerformanceElement {
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
+	PFE_DRAWWORLD_COLLECT, ///< Time spent collecting world viewport sprites
+	PFE_DRAWWORLD_SORT, ///< Time spent sorting world viewport sprites, summed over all threads
 	PFE_VIDEO,         ///< Speed of painting drawn video buffer.
 	PFE_SOUND,         ///< Speed of mixing audio samples
 	PFE_ALLSCRIPTS,    ///< Sum of all GS/AI scripts
@@ -118,8 +120,11 @@ public:
 	PerformanceAccumulator(PerformanceElement elem);
 	~PerformanceAccumulator();
 	static void Reset(PerformanceElement elem);
+	static void AddTime(PerformanceElement elem, TimingMeasurement time);
 };
 
+TimingMeasurement GetPerformanceTimer();
+
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
 
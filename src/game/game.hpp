@@ -24,6 +24,12 @@ public:
 	 */
 	static void GameLoop();
 
+	/**
+	 * Whether the game script was deferred to the next tick by the tick operations budget.
+	 * @return True when the game script has to run before the AIs.
+	 */
+	static bool IsDeferred() { return Game::deferred; }
+
 	/**
 	 * Initialize the Game system.
 	 */
@@ -111,6 +117,7 @@ public:
 
 private:
 	static uint frame_counter;                        ///< Tick counter for the Game code.
+	static bool deferred;                             ///< Whether the game script was deferred to the next tick by the tick operations budget.
 	static class GameInstance *instance;              ///< Instance to the current active Game.
 	static class GameScannerInfo *scanner_info;       ///< Scanner for Game scripts.
 	static class GameScannerLibrary *scanner_library; ///< Scanner for GS Libraries.
@@ -14,6 +14,8 @@
 #include "../network/network.h"
 #include "../window_func.h"
 #include "../framerate_type.h"
+#include "../settings_type.h"
+#include "../ai/ai.hpp"
 #include "game.hpp"
 #include "game_scanner.hpp"
 #include "game_config.hpp"
@@ -23,6 +25,7 @@
 #include "../safeguards.h"
 
 /* static */ uint Game::frame_counter = 0;
+/* static */ bool Game::deferred = false;
 /* static */ GameInfo *Game::info = nullptr;
 /* static */ GameInstance *Game::instance = nullptr;
 /* static */ GameScannerInfo *Game::scanner_info = nullptr;
@@ -39,14 +42,22 @@
 		return;
 	}
 
-	PerformanceMeasurer framerate(PFE_GAMESCRIPT);
-
 	Game::frame_counter++;
 
-	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
-	cur_company.Change(OWNER_DEITY);
-	Game::instance->GameLoop();
-	cur_company.Restore();
+	/* When the AIs used up the operations budget of this tick, run the game script in the next tick instead, before any AI. */
+	const uint32_t budget = _settings_game.script.script_tick_ops_budget;
+	if (budget > 0 && !Game::deferred && AI::GetTickOps() >= budget) {
+		Game::deferred = true;
+		PerformanceMeasurer::Paused(PFE_GAMESCRIPT);
+	} else {
+		Game::deferred = false;
+
+		PerformanceMeasurer framerate(PFE_GAMESCRIPT);
+		Backup<CompanyID> cur_company(_current_company, FILE_LINE);
+		cur_company.Change(OWNER_DEITY);
+		Game::instance->GameLoop();
+		cur_company.Restore();
+	}
 
 	/* Occasionally collect garbage */
 	if ((Game::frame_counter & 255) == 0) {
@@ -59,6 +70,7 @@
 	if (Game::instance != nullptr) Game::Uninitialize(true);
 
 	Game::frame_counter = 0;
+	Game::deferred = false;
 
 	if (Game::scanner_info == nullptr) {
 		TarScanner::DoScan(TarScanner::GAME);
@@ -1506,6 +1506,7 @@ struct GenWorldStatus {
 	uint current;
 	uint total;
 	std::chrono::steady_clock::time_point next_update;
+	std::chrono::steady_clock::time_point stage_start; ///< Time at which the current generation class started.
 };
 
 static GenWorldStatus _gws;
@@ -1615,6 +1616,7 @@ void PrepareGenerateWorldProgress()
 	_gws.total = 0;
 	_gws.percent = 0;
 	_gws.next_update = std::chrono::steady_clock::now();
+	_gws.stage_start = _gws.next_update;
 }
 
 /**
@@ -1648,6 +1650,13 @@ static void _SetGeneratingWorldProgress(GenWorldProgress cls, uint progress, uin
 		_gws.current += progress;
 		assert(_gws.current <= _gws.total);
 	} else {
+		if (_gws.cls != _generation_class_table[cls]) {
+			/* Report how long the previous generation class took */
+			auto now = std::chrono::steady_clock::now();
+			DEBUG(map, 1, "World generation stage %u took %ums", (uint)(std::find(std::begin(_generation_class_table), std::end(_generation_class_table), _gws.cls) - std::begin(_generation_class_table)),
+					(uint)std::chrono::duration_cast<std::chrono::milliseconds>(now - _gws.stage_start).count());
+			_gws.stage_start = now;
+		}
 		_gws.cls     = _generation_class_table[cls];
 		_gws.current = progress;
 		_gws.total   = total;
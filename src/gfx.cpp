@@ -33,7 +33,9 @@
 #include "table/sprites.h"
 #include "table/control_codes.h"
 
+#include <algorithm>
 #include <atomic>
+#include <tuple>
 
 #include "safeguards.h"
 
@@ -111,6 +113,21 @@ enum GfxDebugFlags {
 };
 uint32_t _gfx_debug_flags;
 
+RedrawStatistics _redraw_stats;
+
+void RedrawStats::Add(const RedrawStats &other)
+{
+	this->frames += other.frames;
+	this->whole_screen += other.whole_screen;
+	this->dirty_rects += other.dirty_rects;
+	this->dirty_rect_pixels += other.dirty_rect_pixels;
+	this->window_redraws += other.window_redraws;
+	this->widget_redraws += other.widget_redraws;
+	this->window_paints += other.window_paints;
+	this->window_pixels += other.window_pixels;
+	this->viewport_pixels += other.viewport_pixels;
+}
+
 /**
  * Applies a certain FillRectMode-operation to a rectangle [left, right] x [top, bottom] on the screen.
  *
@@ -1494,6 +1511,9 @@ void RedrawScreenRect(int left, int top, int right, int bottom)
 
 	if (_networking) NetworkUndrawChatMessage();
 
+	_redraw_stats.current.dirty_rects++;
+	_redraw_stats.current.dirty_rect_pixels += (uint64_t)(right - left) * (bottom - top);
+
 	DrawOverlappedWindowForAll(left, top, right, bottom);
 
 	VideoDriver::GetInstance()->MakeDirty(left, top, right - left, bottom - top);
@@ -1548,6 +1568,7 @@ static void DrawDirtyViewport(uint occlusion, int left, int top, int right, int
 		extern void ViewportDrawChk(Viewport *vp, int left, int top, int right, int bottom, uint8_t display_flags);
 		ViewportDrawChk(_dirty_viewport, left, top, right, bottom, _dirty_viewport_disp_flags);
 		VideoDriver::GetInstance()->MakeDirty(left, top, right - left, bottom - top);
+		_redraw_stats.current.viewport_pixels += (uint64_t)(right - left) * (bottom - top);
 	}
 }
 
@@ -1560,6 +1581,56 @@ static void DrawOverlappedWindowWithClipping(Window *w, int left, int top, int r
 	DrawOverlappedWindow(w, std::max(0, left), std::max(0, top), std::min(_screen.width, right), std::min(_screen.height, bottom), flags);
 }
 
+/**
+ * Merge pairs of dirty rectangles which share a whole edge.
+ * The dirty rectangles do not overlap, so this does not change the area to redraw,
+ * but it reduces the number of rectangles, each of which has to be checked against and drawn for each window.
+ * @ingroup dirty
+ */
+static void CoalesceDirtyBlocks()
+{
+	if (_dirty_blocks.size() < 2) return;
+
+	bool merged;
+	do {
+		merged = false;
+
+		/* Merge horizontally adjacent rectangles with the same top and bottom. */
+		std::sort(_dirty_blocks.begin(), _dirty_blocks.end(), [](const Rect &a, const Rect &b) {
+			return std::tie(a.top, a.bottom, a.left) < std::tie(b.top, b.bottom, b.left);
+		});
+		size_t out = 0;
+		for (size_t i = 1; i < _dirty_blocks.size(); i++) {
+			const Rect &r = _dirty_blocks[i];
+			Rect &prev = _dirty_blocks[out];
+			if (prev.top == r.top && prev.bottom == r.bottom && prev.right == r.left) {
+				prev.right = r.right;
+				merged = true;
+			} else {
+				_dirty_blocks[++out] = r;
+			}
+		}
+		_dirty_blocks.resize(out + 1);
+
+		/* Merge vertically adjacent rectangles with the same left and right. */
+		std::sort(_dirty_blocks.begin(), _dirty_blocks.end(), [](const Rect &a, const Rect &b) {
+			return std::tie(a.left, a.right, a.top) < std::tie(b.left, b.right, b.top);
+		});
+		out = 0;
+		for (size_t i = 1; i < _dirty_blocks.size(); i++) {
+			const Rect &r = _dirty_blocks[i];
+			Rect &prev = _dirty_blocks[out];
+			if (prev.left == r.left && prev.right == r.right && prev.bottom == r.top) {
+				prev.bottom = r.bottom;
+				merged = true;
+			} else {
+				_dirty_blocks[++out] = r;
+			}
+		}
+		_dirty_blocks.resize(out + 1);
+	} while (merged && _dirty_blocks.size() > 1);
+}
+
 /**
  * Repaints the rectangle blocks which are marked as 'dirty'.
  *
@@ -1577,6 +1648,7 @@ void DrawDirtyBlocks()
 	_gfx_draw_active = true;
 
 	if (_whole_screen_dirty) {
+		_redraw_stats.current.whole_screen++;
 		RedrawScreenRect(0, 0, _screen.width, _screen.height);
 		for (Window *w : Window::Iterate()) {
 			w->flags &= ~(WF_DIRTY | WF_WIDGETS_DIRTY | WF_DRAG_DIRTIED);
@@ -1594,6 +1666,8 @@ void DrawDirtyBlocks()
 		DrawPixelInfo bk;
 		Backup dpi_backup(_cur_dpi, &bk, FILE_LINE);
 
+		CoalesceDirtyBlocks();
+
 		for (Window *w : Window::IterateFromBack()) {
 			w->flags &= ~WF_DRAG_DIRTIED;
 			if (!MayBeShown(w)) continue;
@@ -1608,6 +1682,7 @@ void DrawDirtyBlocks()
 				}
 				DrawOverlappedWindowWithClipping(w, w->left, w->top, w->left + w->width, w->top + w->height, flags);
 				w->flags &= ~(WF_DIRTY | WF_WIDGETS_DIRTY);
+				_redraw_stats.current.window_redraws++;
 			} else if (w->flags & WF_WIDGETS_DIRTY) {
 				if (w->nested_root != nullptr) {
 					clear_overlays();
@@ -1619,6 +1694,7 @@ void DrawDirtyBlocks()
 						}
 						DrawOverlappedWindowWithClipping(w, w->left + widget->pos_x, w->top + widget->pos_y, w->left + widget->pos_x + widget->current_x, w->top + widget->pos_y + widget->current_y, flags);
 					}
+					_redraw_stats.current.widget_redraws += dirty_widgets.size();
 					dirty_widgets.clear();
 				}
 				w->flags &= ~WF_WIDGETS_DIRTY;
@@ -1739,6 +1815,7 @@ void DrawDirtyBlocks()
 
 		dpi_backup.Restore();
 
+		CoalesceDirtyBlocks();
 		for (const Rect &r : _dirty_blocks) {
 			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
 		}
@@ -1756,6 +1833,7 @@ void DrawDirtyBlocks()
 			SetDirtyBlocks(r.left, r.top, r.right, r.bottom);
 		}
 		_pending_dirty_blocks.clear();
+		CoalesceDirtyBlocks();
 		for (const Rect &r : _dirty_blocks) {
 			RedrawScreenRect(r.left, r.top, r.right, r.bottom);
 		}
@@ -1765,6 +1843,11 @@ void DrawDirtyBlocks()
 	_gfx_draw_active = false;
 	_dirty_block_colour.fetch_add(1, std::memory_order_relaxed);
 
+	_redraw_stats.current.frames++;
+	_redraw_stats.last_frame = _redraw_stats.current;
+	_redraw_stats.total.Add(_redraw_stats.current);
+	_redraw_stats.current = {};
+
 	extern void ClearViewportCaches();
 	ClearViewportCaches();
 }
@@ -169,6 +169,30 @@ void SetPendingDirtyBlocks(int left, int top, int right, int bottom);
 void UnsetDirtyBlocks(int left, int top, int right, int bottom);
 void MarkWholeScreenDirty();
 
+/** Statistics of the screen redraws, see the redraw_stats console command. */
+struct RedrawStats {
+	uint64_t frames = 0;            ///< Number of calls to DrawDirtyBlocks.
+	uint64_t whole_screen = 0;      ///< Number of whole screen redraws.
+	uint64_t dirty_rects = 0;       ///< Number of dirty rectangles redrawn, after coalescing.
+	uint64_t dirty_rect_pixels = 0; ///< Area of the dirty rectangles redrawn.
+	uint64_t window_redraws = 0;    ///< Number of whole windows redrawn because they were marked dirty.
+	uint64_t widget_redraws = 0;    ///< Number of widgets redrawn because they were marked dirty.
+	uint64_t window_paints = 0;     ///< Number of window paint calls, after splitting around overlapping windows.
+	uint64_t window_pixels = 0;     ///< Area painted by the window paint calls.
+	uint64_t viewport_pixels = 0;   ///< Area of the viewport dirty blocks redrawn.
+
+	void Add(const RedrawStats &other);
+};
+
+/** Redraw statistics of the frame being drawn, the last frame and all frames since the last reset. */
+struct RedrawStatistics {
+	RedrawStats current;
+	RedrawStats last_frame;
+	RedrawStats total;
+};
+
+extern RedrawStatistics _redraw_stats;
+
 void CheckBlitter();
 
 bool FillDrawPixelInfo(DrawPixelInfo *n, int left, int top, int width, int height);
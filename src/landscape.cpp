@@ -37,6 +37,8 @@
 #include "scope_info.h"
 #include "core/ring_buffer.hpp"
 #include "network/network_sync.h"
+#include "debug_settings.h"
+#include "newgrf.h"
 #include <array>
 #include <list>
 #include <set>
@@ -748,6 +750,42 @@ void SetupTileLoopCounts()
 	if (accumulator > 0) _tile_loop_counts[0]++;
 }
 
+/**
+ * Check whether calling the tile loop handler of a tile has no effect, and will not have any effect until the tile is changed.
+ * Every change to the tile state checked here must wake the tile, see WakeTileLoopTile.
+ * @param tile The tile to check, after its tile loop handler has been called.
+ * @return true if the tile is idle.
+ */
+static bool IsTileLoopIdleTile(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_WATER:
+			/* Water which does not flood any neighbouring tiles, this is cleared when a neighbouring tile changes. */
+			return IsNonFloodingWaterTile(tile);
+
+		case MP_CLEAR:
+			/* Snow and desert ground depend on the snow line and tropic zone in the other climates. */
+			if (_settings_game.game_creation.landscape != LT_TEMPERATE) return false;
+			switch (GetClearGround(tile)) {
+				case CLEAR_GRASS:  return GetClearDensity(tile) == 3;
+				case CLEAR_FIELDS: return false;
+				default:           return true;
+			}
+
+		default:
+			return false;
+	}
+}
+
+/**
+ * Whether tiles which are idle in the tile loop can be skipped.
+ * The ambient sound callback and the scenario editor use the tile loop of otherwise idle tiles.
+ */
+static bool CanSkipIdleTileLoopTiles()
+{
+	return HasChickenBit(DCBF_TILE_LOOP_SKIP_IDLE) && _game_mode != GM_EDITOR && !HasGrfMiscBit(GMB_AMBIENT_SOUND_CALLBACK);
+}
+
 /**
  * Gradually iterate over all tiles on the map, calling their TileLoopProcs once every 256 ticks.
  */
@@ -778,16 +816,34 @@ void RunTileLoop(bool apply_day_length)
 		count--;
 	}
 
-	while (count--) {
-		/* Get the next tile in sequence using a Galois LFSR. */
-		TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
-		if (count > 0) {
-			PREFETCH_NTA(&_m[next]);
+	if (CanSkipIdleTileLoopTiles()) {
+		/* Only visit tiles which are not idle, this keeps the same order and frequency for all other tiles */
+		while (count--) {
+			/* Get the next tile in sequence using a Galois LFSR. */
+			TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
+			if (count > 0 && !IsTileLoopIdle(next)) {
+				PREFETCH_NTA(&_m[next]);
+			}
+
+			if (!IsTileLoopIdle(tile)) {
+				_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+				if (IsTileLoopIdleTile(tile)) SetTileLoopIdle(tile);
+			}
+
+			tile = next;
 		}
+	} else {
+		while (count--) {
+			/* Get the next tile in sequence using a Galois LFSR. */
+			TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
+			if (count > 0) {
+				PREFETCH_NTA(&_m[next]);
+			}
 
-		_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
+			_tile_type_procs[GetTileType(tile)]->tile_loop_proc(tile);
 
-		tile = next;
+			tile = next;
+		}
 	}
 
 	_cur_tileloop_tile = tile;
@@ -805,13 +861,21 @@ void RunAuxiliaryTileLoop()
 	uint count = 1 << (MapLogX() + MapLogY() - 8);
 	TileIndex tile = _aux_tileloop_tile;
 
+	/* Idle tiles never flood */
+	const bool skip_idle = CanSkipIdleTileLoopTiles();
+
 	while (count--) {
 		/* Get the next tile in sequence using a Galois LFSR. */
 		TileIndex next = (tile >> 1) ^ (-(int32_t)(tile & 1) & feedback);
-		if (count > 0) {
+		if (count > 0 && !(skip_idle && IsTileLoopIdle(next))) {
 			PREFETCH_NTA(&_m[next]);
 		}
 
+		if (skip_idle && IsTileLoopIdle(tile)) {
+			tile = next;
+			continue;
+		}
+
 		if (IsFloodingTypeTile(tile) && !IsNonFloodingWaterTile(tile)) {
 			FloodingBehaviour fb = GetFloodingBehaviour(tile);
 			if (fb != FLOOD_NONE) TileLoopWaterFlooding(fb, tile);
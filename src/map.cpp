@@ -40,6 +40,7 @@ uint _map_tile_mask; ///< _map_size - 1 (to mask the mapsize)
 
 Tile *_m = nullptr;          ///< Tiles of the map
 TileExtended *_me = nullptr; ///< Extended Tiles of the map
+uint64_t *_tile_loop_idle = nullptr; ///< Tiles which are idle in the tile loop
 
 #if defined(__linux__) && defined(MADV_HUGEPAGE)
 static size_t _munmap_size = 0;
@@ -135,6 +136,9 @@ void AllocateMap(uint size_x, uint size_y)
 	_m = reinterpret_cast<Tile *>(buf);
 	_me = reinterpret_cast<TileExtended *>(buf + (_map_size * sizeof(Tile)));
 
+	free(_tile_loop_idle);
+	_tile_loop_idle = CallocT<uint64_t>(_map_size / 64);
+
 	InitializeWaterRegions();
 }
 
@@ -41,6 +41,42 @@ extern Tile *_m;
  */
 extern TileExtended *_me;
 
+/**
+ * Bitmap of tiles which are idle in the tile loop, one bit per tile.
+ *
+ * A set bit means that the tile loop handler of the tile is known to have
+ * no effect until the tile is changed, see RunTileLoop.
+ */
+extern uint64_t *_tile_loop_idle;
+
+/**
+ * Check whether a tile is marked as idle in the tile loop.
+ * @param tile the tile to check
+ * @return true if the tile is idle
+ */
+inline bool IsTileLoopIdle(TileIndex tile)
+{
+	return (_tile_loop_idle[tile / 64] >> (tile % 64)) & 1;
+}
+
+/**
+ * Mark a tile as idle in the tile loop.
+ * @param tile the tile to mark
+ */
+inline void SetTileLoopIdle(TileIndex tile)
+{
+	_tile_loop_idle[tile / 64] |= static_cast<uint64_t>(1) << (tile % 64);
+}
+
+/**
+ * Wake a tile which may be idle in the tile loop, because its contents have changed.
+ * @param tile the tile to wake
+ */
+inline void WakeTileLoopTile(TileIndex tile)
+{
+	_tile_loop_idle[tile / 64] &= ~(static_cast<uint64_t>(1) << (tile % 64));
+}
+
 bool ValidateMapSize(uint size_x, uint size_y);
 void AllocateMap(uint size_x, uint size_y);
 
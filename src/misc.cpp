@@ -42,6 +42,7 @@
 #include "event_logs.h"
 #include "string_func.h"
 #include "plans_func.h"
+#include "screenshot.h"
 #include "core/format.hpp"
 #include "3rdparty/monocypher/monocypher.h"
 
@@ -120,6 +121,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	AllocateMap(size_x, size_y);
 
 	ViewportMapClearTunnelCache();
+	ResetMapTileExport();
 	ResetDisasterVehicleTargeting();
 	ClearCommandLog();
 	ClearCommandQueue();
@@ -105,8 +105,20 @@ typedef unsigned long in_addr_t;
 
 #	include <errno.h>
 #	include <sys/time.h>
+#	include <sys/uio.h>
 #	include <netdb.h>
 
+/* Sending multiple buffers with one call. */
+#	if !defined(__EMSCRIPTEN__)
+#		define NETWORK_HAVE_SENDMSG
+#	endif
+
+/* Readiness notifications without passing all sockets on each check. */
+#	if defined(__linux__)
+#		include <sys/epoll.h>
+#		define NETWORK_HAVE_EPOLL
+#	endif
+
 #   if defined(__EMSCRIPTEN__)
 /* Emscripten doesn't support AI_ADDRCONFIG and errors out on it. */
 #		undef AI_ADDRCONFIG
@@ -20,6 +20,7 @@
 #include <string>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <vector>
 
 typedef uint16_t PacketSize; ///< Size of the whole packet.
@@ -192,6 +193,24 @@ public:
 	NetworkSocketHandler *GetParentSocket() { return this->cs; }
 };
 
+/**
+ * A packet which has been prepared for sending and is not modified anymore.
+ * This can be queued on the send queues of multiple sockets, so a packet which is broadcast
+ * to many clients only has to be created and encoded once.
+ */
+using SharedPacket = std::shared_ptr<const Packet>;
+
+/**
+ * Prepare a packet for sending, so it can be queued on the send queues of multiple sockets.
+ * @param packet The packet to share.
+ * @return The shared packet.
+ */
+inline SharedPacket PrepareSharedPacket(std::unique_ptr<Packet> packet)
+{
+	packet->PrepareToSend();
+	return SharedPacket(std::move(packet));
+}
+
 struct SubPacketDeserialiser : public BufferDeserialisationHelper<SubPacketDeserialiser> {
 	NetworkSocketHandler *cs;
 	const byte *data;
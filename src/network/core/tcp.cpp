@@ -22,7 +22,7 @@
  */
 NetworkTCPSocketHandler::NetworkTCPSocketHandler(SOCKET s) :
 		NetworkSocketHandler(),
-		sock(s), writable(false)
+		sock(s), writable(false), readable(false)
 {
 }
 
@@ -52,6 +52,7 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool
 {
 	this->MarkClosed();
 	this->writable = false;
+	this->readable = false;
 
 	this->packet_queue.clear();
 	this->packet_recv = nullptr;
@@ -71,7 +72,19 @@ void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> packet)
 
 	packet->PrepareToSend();
 
-	this->packet_queue.push_back(std::move(packet));
+	this->packet_queue.emplace_back(std::move(packet));
+}
+
+/**
+ * This function puts a packet which can also be queued on other sockets
+ * in the send-queue, without copying it.
+ * @param packet the packet to send, which must have been prepared with PrepareSharedPacket
+ */
+void NetworkTCPSocketHandler::SendPacket(SharedPacket packet)
+{
+	assert(packet != nullptr);
+
+	this->packet_queue.emplace_back(std::move(packet));
 }
 
 /**
@@ -88,21 +101,21 @@ void NetworkTCPSocketHandler::SendPrependPacket(std::unique_ptr<Packet> packet,
 
 	if (queue_after_packet_type >= 0) {
 		for (auto iter = this->packet_queue.begin(); iter != this->packet_queue.end(); ++iter) {
-			if ((*iter)->GetPacketType() == queue_after_packet_type) {
+			if (iter->Get().GetPacketType() == queue_after_packet_type) {
 				++iter;
-				this->packet_queue.insert(iter, std::move(packet));
+				this->packet_queue.emplace(iter, std::move(packet));
 				return;
 			}
 		}
 	}
 
 	/* The very first packet in the queue may be partially written out, so cannot be replaced.
-	 * If the queue is non-empty, swap packet with the first packet in the queue.
-	 * The insert the packet (either the incoming packet or the previous first packet) at the front. */
+	 * If the queue is non-empty, insert the packet after the first packet in the queue. */
 	if (!this->packet_queue.empty()) {
-		packet.swap(this->packet_queue.front());
+		this->packet_queue.emplace(std::next(this->packet_queue.begin()), std::move(packet));
+	} else {
+		this->packet_queue.emplace_front(std::move(packet));
 	}
-	this->packet_queue.push_front(std::move(packet));
 }
 
 /**
@@ -113,15 +126,20 @@ void NetworkTCPSocketHandler::ShrinkToFitSendQueue()
 	this->packet_queue.shrink_to_fit();
 }
 
+/** Maximum number of packets to write out with one system call. */
+static const uint SEND_PACKETS_MAX_BUFFERS = 64;
+
 /**
  * Sends all the buffered packets out for this client. It stops when:
  *   1) all packets are send (queue is empty)
  *   2) the OS reports back that it can not send any more
  *      data right now (full network-buffer, it happens ;))
  *   3) sending took too long
+ * Where supported, multiple queued packets are written out with a single system call.
  * @param closing_down Whether we are closing down the connection.
  * @return \c true if a (part of a) packet could be sent and
  *         the connection is not closed yet.
+ * @note Clears #writable when the OS can not send any more data right now.
  */
 SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 {
@@ -130,8 +148,27 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	if (!this->IsConnected()) return SPS_CLOSED;
 
 	while (!this->packet_queue.empty()) {
-		Packet &p = *this->packet_queue.front();
-		ssize_t res = p.TransferOut<int>(send, this->sock, 0);
+#ifdef NETWORK_HAVE_SENDMSG
+		struct iovec iov[SEND_PACKETS_MAX_BUFFERS];
+		uint buffers = 0;
+		size_t to_send = 0;
+		for (const QueuedPacket &item : this->packet_queue) {
+			iov[buffers].iov_base = const_cast<byte *>(item.Get().GetBufferData() + item.pos);
+			iov[buffers].iov_len = item.RemainingBytesToTransfer();
+			to_send += iov[buffers].iov_len;
+			if (++buffers == SEND_PACKETS_MAX_BUFFERS) break;
+		}
+
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = buffers;
+		ssize_t res = sendmsg(this->sock, &msg, 0);
+#else
+		QueuedPacket &item = this->packet_queue.front();
+		size_t to_send = item.RemainingBytesToTransfer();
+		ssize_t res = send(this->sock, reinterpret_cast<const char *>(item.Get().GetBufferData() + item.pos), static_cast<int>(to_send), 0);
+#endif
 		if (res == -1) {
 			NetworkError err = NetworkError::GetLast();
 			if (!err.WouldBlock()) {
@@ -142,6 +179,7 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 				}
 				return SPS_CLOSED;
 			}
+			this->writable = false;
 			return SPS_PARTLY_SENT;
 		}
 		if (res == 0) {
@@ -150,12 +188,22 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
-		/* Is this packet sent? */
-		if (p.RemainingBytesToTransfer() == 0) {
-			/* Go to the next packet */
-			if (_debug_net_level >= 5) this->LogSentPacket(p);
-			this->packet_queue.pop_front();
-		} else {
+		/* Account for what has been sent, and go to the next packets. */
+		size_t sent = res;
+		while (sent > 0) {
+			QueuedPacket &item = this->packet_queue.front();
+			size_t amount = std::min(sent, item.RemainingBytesToTransfer());
+			item.pos += amount;
+			sent -= amount;
+			if (item.RemainingBytesToTransfer() == 0) {
+				if (_debug_net_level >= 5) this->LogSentPacket(item.Get());
+				this->packet_queue.pop_front();
+			}
+		}
+
+		/* A partial write means that the OS buffer is full. */
+		if (static_cast<size_t>(res) < to_send) {
+			this->writable = false;
 			return SPS_PARTLY_SENT;
 		}
 	}
@@ -166,6 +214,7 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 /**
  * Receives a packet for the given client
  * @return The received packet (or nullptr when it didn't receive one)
+ * @note Clears #readable when there is nothing more to read right now.
  */
 std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 {
@@ -192,6 +241,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 					return nullptr;
 				}
 				/* Connection would block, so stop for now */
+				this->readable = false;
 				return nullptr;
 			}
 			if (res == 0) {
@@ -221,6 +271,7 @@ std::unique_ptr<Packet> NetworkTCPSocketHandler::ReceivePacket()
 				return nullptr;
 			}
 			/* Connection would block */
+			this->readable = false;
 			return nullptr;
 		}
 		if (res == 0) {
@@ -34,12 +34,27 @@ enum SendPacketsState {
 /** Base socket handler for all TCP sockets */
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
-	ring_buffer<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery
+	/** A packet awaiting delivery. */
+	struct QueuedPacket {
+		std::unique_ptr<Packet> owned; ///< The packet, when it is only queued for this socket.
+		SharedPacket shared;           ///< The packet, when it might be queued for other sockets too.
+		size_t pos = 0;                ///< The number of bytes of the packet which have been sent.
+
+		QueuedPacket(std::unique_ptr<Packet> packet) : owned(std::move(packet)) {}
+		QueuedPacket(SharedPacket packet) : shared(std::move(packet)) {}
+
+		const Packet &Get() const { return this->owned != nullptr ? *this->owned : *this->shared; }
+		size_t RemainingBytesToTransfer() const { return this->Get().Size() - this->pos; }
+	};
+
+	ring_buffer<QueuedPacket> packet_queue;            ///< Packets that are awaiting delivery
 	std::unique_ptr<Packet> packet_recv;               ///< Partially received packet
 
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
+	bool readable;            ///< Might there be something to read from this socket?
+	uint32_t poll_id = 0;     ///< ID of the epoll instance this socket is registered with, 0 if none.
 
 	/**
 	 * Whether this socket is currently bound to a socket.
@@ -51,6 +66,7 @@ public:
 	void CloseSocket();
 
 	void SendPacket(std::unique_ptr<Packet> packet);
+	void SendPacket(SharedPacket packet);
 	void SendPrependPacket(std::unique_ptr<Packet> packet, int queue_after_packet_type);
 	void ShrinkToFitSendQueue();
 
@@ -61,6 +61,9 @@ enum PacketAdminType : uint8_t {
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
 
+	/* Packets specific to this patch pack, in their own range so that they cannot collide with future upstream packets. */
+	ADMIN_PACKET_SERVER_SNAPSHOT = 0xE0, ///< The server sends (part of) a binary snapshot of the game state.
+
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
 
@@ -83,9 +86,43 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_UPSTREAM_END,    ///< End of the upstream update types, the types from here on are specific to this patch pack.
+	ADMIN_UPDATE_SNAPSHOT = ADMIN_UPDATE_UPSTREAM_END, ///< The admin would like to have binary snapshots of vehicles, stations, links and towns.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
+/**
+ * First ID of the update types specific to this patch pack in the admin protocol.
+ * These are kept apart from the upstream IDs, so that they cannot collide with future upstream update types.
+ * This must stay below 256, as ADMIN_PACKET_ADMIN_POLL sends the update type as a byte.
+ */
+static const uint16_t ADMIN_UPDATE_PATCH_ID_BASE = 0xC0;
+
+/**
+ * Get the ID of an update type in the admin protocol.
+ * @param type The update type.
+ * @return The ID.
+ */
+inline uint16_t AdminUpdateTypeToID(AdminUpdateType type)
+{
+	if (type < ADMIN_UPDATE_UPSTREAM_END) return type;
+	return ADMIN_UPDATE_PATCH_ID_BASE + (type - ADMIN_UPDATE_UPSTREAM_END);
+}
+
+/**
+ * Get the update type with an ID in the admin protocol.
+ * @param id The ID.
+ * @return The update type, or ADMIN_UPDATE_END if the ID is not known.
+ */
+inline AdminUpdateType AdminUpdateTypeFromID(uint16_t id)
+{
+	if (id < ADMIN_UPDATE_UPSTREAM_END) return (AdminUpdateType)id;
+	if (id >= ADMIN_UPDATE_PATCH_ID_BASE && id < ADMIN_UPDATE_PATCH_ID_BASE + (ADMIN_UPDATE_END - ADMIN_UPDATE_UPSTREAM_END)) {
+		return (AdminUpdateType)(ADMIN_UPDATE_UPSTREAM_END + (id - ADMIN_UPDATE_PATCH_ID_BASE));
+	}
+	return ADMIN_UPDATE_END;
+}
+
 /** Update frequencies an admin can register. */
 enum AdminUpdateFrequency {
 	ADMIN_FREQUENCY_POLL      = 0x01, ///< The admin can poll this.
@@ -98,6 +135,23 @@ enum AdminUpdateFrequency {
 };
 DECLARE_ENUM_AS_BIT_SET(AdminUpdateFrequency)
 
+/** Sections of a game state snapshot, see #ADMIN_PACKET_SERVER_SNAPSHOT. */
+enum AdminSnapshotSection {
+	ADMIN_SNAPSHOT_BEGIN,    ///< Start of a snapshot.
+	ADMIN_SNAPSHOT_VEHICLES, ///< Records of the primary vehicles.
+	ADMIN_SNAPSHOT_STATIONS, ///< Records of the stations, with their cargo.
+	ADMIN_SNAPSHOT_LINKS,    ///< Records of the link graph edges.
+	ADMIN_SNAPSHOT_TOWNS,    ///< Records of the towns.
+	ADMIN_SNAPSHOT_END,      ///< End of a snapshot.
+};
+
+/** Operations in a section of a game state snapshot, see #ADMIN_PACKET_SERVER_SNAPSHOT. */
+enum AdminSnapshotOperation {
+	ADMIN_SNAPSHOT_OP_END,    ///< No more records in this packet.
+	ADMIN_SNAPSHOT_OP_UPDATE, ///< A new or changed record follows.
+	ADMIN_SNAPSHOT_OP_REMOVE, ///< The key of a removed record follows.
+};
+
 /** Reasons for removing a company - communicated to admins. */
 enum AdminCompanyRemoveReason {
 	ADMIN_CRR_MANUAL,    ///< The company is manually removed.
@@ -489,6 +543,25 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet &p);
 
+	/**
+	 * Send (part of) a binary snapshot of the game state.
+	 * A snapshot consists of a packet for #ADMIN_SNAPSHOT_BEGIN, packets for the record sections, and
+	 * a packet for #ADMIN_SNAPSHOT_END. Unless the snapshot is full, the record sections only contain
+	 * the records which changed since the previous snapshot sent to this admin.
+	 * uint32_t  Number of the snapshot.
+	 * uint8_t   Section of the snapshot (see #AdminSnapshotSection).
+	 * For #ADMIN_SNAPSHOT_BEGIN:
+	 * bool      Whether this is a full snapshot, instead of the changes since the previous snapshot.
+	 * uint32_t  Current calendar date.
+	 * uint32_t  Current frame.
+	 * For the record sections, repeated until #ADMIN_SNAPSHOT_OP_END:
+	 * uint8_t   Operation (see #AdminSnapshotOperation), followed by the record for an update or only its key for a removal.
+	 * See docs/admin_network.md for the layout of the records.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_SNAPSHOT(Packet &p);
+
 	NetworkRecvStatus HandlePacket(Packet &p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
@@ -29,6 +29,80 @@ class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
 
+#ifdef NETWORK_HAVE_EPOLL
+	/** Tag for the epoll data of the sockets we listen on; the other entries are (pool index << 32) | socket. */
+	static const uint64_t EPOLL_LISTENER = 1ULL << 63;
+
+	static int epoll_fd;                                ///< The epoll instance for the listeners and connections, or -1 when using select.
+	static uint32_t epoll_id;                           ///< ID of the current epoll instance, to know which sockets still have to be registered.
+	static std::vector<struct epoll_event> epoll_events; ///< Buffer for the events returned by epoll.
+
+	/**
+	 * Register the connections which are not yet registered with the epoll instance.
+	 * Connections are registered edge-triggered, so the readable/writable flags of a socket are only set again by
+	 * an event after the socket has reported that it would block.
+	 */
+	static void RegisterWithEpoll()
+	{
+		for (Tsocket *cs : Tsocket::Iterate()) {
+			if (cs->poll_id == epoll_id || cs->sock == INVALID_SOCKET) continue;
+
+			struct epoll_event ev;
+			ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+			ev.data.u64 = (static_cast<uint64_t>(cs->index) << 32) | static_cast<uint32_t>(cs->sock);
+			if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, cs->sock, &ev) != 0 && (errno != EEXIST || epoll_ctl(epoll_fd, EPOLL_CTL_MOD, cs->sock, &ev) != 0)) {
+				DEBUG(net, 0, "[%s] epoll_ctl failed: %s", Tsocket::GetName(), NetworkError::GetLast().AsString());
+				continue;
+			}
+			cs->poll_id = epoll_id;
+
+			/* Nothing is known about the state of the socket yet, so try both. */
+			cs->readable = true;
+			cs->writable = true;
+		}
+	}
+
+	/**
+	 * Handle the receiving of packets using epoll.
+	 * @return true if everything went okay.
+	 */
+	static bool ReceiveEpoll()
+	{
+		RegisterWithEpoll();
+
+		int count = epoll_wait(epoll_fd, epoll_events.data(), static_cast<int>(epoll_events.size()), 0); // don't block at all.
+		if (count < 0) {
+			if (errno != EINTR) return false;
+			count = 0;
+		}
+
+		for (int i = 0; i < count; i++) {
+			const struct epoll_event &ev = epoll_events[i];
+			if (ev.data.u64 & EPOLL_LISTENER) {
+				/* accept clients.. */
+				AcceptClient(static_cast<SOCKET>(static_cast<uint32_t>(ev.data.u64)));
+				continue;
+			}
+
+			/* The connection might have been closed and its slot reused since the event was queued. */
+			Tsocket *cs = Tsocket::GetIfValid(static_cast<size_t>(ev.data.u64 >> 32));
+			if (cs == nullptr || cs->poll_id != epoll_id || static_cast<uint32_t>(cs->sock) != static_cast<uint32_t>(ev.data.u64)) continue;
+			if (ev.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) cs->readable = true;
+			if (ev.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) cs->writable = true;
+		}
+		if (static_cast<size_t>(count) == epoll_events.size()) epoll_events.resize(epoll_events.size() * 2);
+
+		/* Newly accepted clients can be read from straight away. */
+		RegisterWithEpoll();
+
+		/* read stuff from clients */
+		for (Tsocket *cs : Tsocket::Iterate()) {
+			if (cs->readable) cs->ReceivePackets();
+		}
+		return _networking;
+	}
+#endif /* NETWORK_HAVE_EPOLL */
+
 public:
 	static bool ValidateClient(SOCKET s, NetworkAddress &address)
 	{
@@ -100,6 +174,10 @@ public:
 	 */
 	static bool Receive()
 	{
+#ifdef NETWORK_HAVE_EPOLL
+		if (epoll_fd >= 0) return ReceiveEpoll();
+#endif /* NETWORK_HAVE_EPOLL */
+
 		fd_set read_fd, write_fd;
 		struct timeval tv;
 
@@ -128,7 +206,8 @@ public:
 		/* read stuff from clients */
 		for (Tsocket *cs : Tsocket::Iterate()) {
 			cs->writable = !!FD_ISSET(cs->sock, &write_fd);
-			if (FD_ISSET(cs->sock, &read_fd)) {
+			cs->readable = !!FD_ISSET(cs->sock, &read_fd);
+			if (cs->readable) {
 				cs->ReceivePackets();
 			}
 		}
@@ -157,6 +236,27 @@ public:
 			return false;
 		}
 
+#ifdef NETWORK_HAVE_EPOLL
+		epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll_fd < 0) {
+			DEBUG(net, 1, "[%s] epoll_create1 failed, falling back to select: %s", Tsocket::GetName(), NetworkError::GetLast().AsString());
+			return true;
+		}
+		epoll_id++;
+		epoll_events.resize(64);
+		for (auto &s : sockets) {
+			struct epoll_event ev;
+			ev.events = EPOLLIN;
+			ev.data.u64 = EPOLL_LISTENER | static_cast<uint32_t>(s.first);
+			if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, s.first, &ev) != 0) {
+				DEBUG(net, 1, "[%s] epoll_ctl failed, falling back to select: %s", Tsocket::GetName(), NetworkError::GetLast().AsString());
+				close(epoll_fd);
+				epoll_fd = -1;
+				break;
+			}
+		}
+#endif /* NETWORK_HAVE_EPOLL */
+
 		return true;
 	}
 
@@ -167,10 +267,22 @@ public:
 			closesocket(s.first);
 		}
 		sockets.clear();
+#ifdef NETWORK_HAVE_EPOLL
+		if (epoll_fd >= 0) {
+			close(epoll_fd);
+			epoll_fd = -1;
+		}
+		epoll_events.clear();
+#endif /* NETWORK_HAVE_EPOLL */
 		DEBUG(net, 5, "[%s] Closed listeners", Tsocket::GetName());
 	}
 };
 
 template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketList TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::sockets;
+#ifdef NETWORK_HAVE_EPOLL
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> int TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll_fd = -1;
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> uint32_t TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll_id = 0;
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> std::vector<struct epoll_event> TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll_events;
+#endif /* NETWORK_HAVE_EPOLL */
 
 #endif /* NETWORK_CORE_TCP_LISTEN_H */
@@ -55,6 +55,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_SNAPSHOT
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -108,6 +109,9 @@ ServerNetworkAdminSocketHandler::~ServerNetworkAdminSocketHandler()
 			as->CloseConnection(true);
 			continue;
 		}
+		for (auto &p : as->snapshot->TakePackets()) {
+			as->SendPacket(std::move(p));
+		}
 		if (as->writable) {
 			as->SendPackets();
 		}
@@ -157,7 +161,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendProtocol()
 
 	for (int i = 0; i < ADMIN_UPDATE_END; i++) {
 		p->Send_bool  (true);
-		p->Send_uint16(i);
+		p->Send_uint16(AdminUpdateTypeToID((AdminUpdateType)i));
 		p->Send_uint16(_admin_update_type_frequencies[i]);
 	}
 
@@ -170,6 +174,9 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendProtocol()
 /** Send a welcome message to the admin. */
 NetworkRecvStatus ServerNetworkAdminSocketHandler::SendWelcome()
 {
+	/* A new game always starts with a full snapshot. */
+	this->snapshot->Reset();
+
 	auto p = std::make_unique<Packet>(ADMIN_PACKET_SERVER_WELCOME);
 
 	p->Send_string(_settings_client.network.server_name);
@@ -574,6 +581,22 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPong(uint32_t d1)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Start a snapshot of the game state, it is queued once it has been encoded.
+ * Nothing is sent when the previous snapshot is still being encoded or was started too recently,
+ * or when packets are still waiting to be sent to the admin.
+ * @param full Whether to send the complete state, instead of the changes since the previous snapshot.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendSnapshot(bool full)
+{
+	/* A slow admin would otherwise get more and more snapshots queued. */
+	if (this->HasSendQueue()) return NETWORK_RECV_STATUS_OKAY;
+
+	this->snapshot->Start(full, std::chrono::seconds(_settings_client.network.admin_snapshot_interval));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /** Send the names of the commands. */
 NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdNames()
 {
@@ -674,7 +697,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_UPDATE_FREQUENC
 {
 	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
 
-	AdminUpdateType type = (AdminUpdateType)p.Recv_uint16();
+	AdminUpdateType type = AdminUpdateTypeFromID(p.Recv_uint16());
 	AdminUpdateFrequency freq = (AdminUpdateFrequency)p.Recv_uint16();
 
 	if (type >= ADMIN_UPDATE_END || (_admin_update_type_frequencies[type] & freq) != freq) {
@@ -694,7 +717,7 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet &p)
 {
 	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
 
-	AdminUpdateType type = (AdminUpdateType)p.Recv_uint8();
+	AdminUpdateType type = AdminUpdateTypeFromID(p.Recv_uint8());
 	uint32_t d1 = p.Recv_uint32();
 
 	switch (type) {
@@ -747,6 +770,11 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet &p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_SNAPSHOT:
+			/* The admin is requesting a snapshot, d1 is non-zero for a full snapshot. */
+			this->SendSnapshot(d1 != 0);
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 1, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name.c_str(), this->admin_version.c_str());
@@ -1011,6 +1039,10 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_SNAPSHOT:
+						as->SendSnapshot(false);
+						break;
+
 					default: NOT_REACHED();
 				}
 			}
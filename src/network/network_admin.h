@@ -13,6 +13,7 @@
 #include "network_internal.h"
 #include "core/tcp_listen.h"
 #include "core/tcp_admin.h"
+#include "network_admin_snapshot.h"
 
 extern AdminIndex _redirect_console_to_admin;
 
@@ -40,6 +41,7 @@ public:
 	AdminUpdateFrequency update_frequency[ADMIN_UPDATE_END]; ///< Admin requested update intervals.
 	std::chrono::steady_clock::time_point connect_time;      ///< Time of connection.
 	NetworkAddress address;                                  ///< Address of the admin.
+	std::shared_ptr<AdminSnapshotEncoder> snapshot = std::make_shared<AdminSnapshotEncoder>(); ///< Snapshots of the game state sent to this admin.
 
 	ServerNetworkAdminSocketHandler(SOCKET s);
 	~ServerNetworkAdminSocketHandler();
@@ -69,6 +71,7 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket &cp);
 	NetworkRecvStatus SendRconEnd(const std::string_view command);
+	NetworkRecvStatus SendSnapshot(bool full);
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
@@ -0,0 +1,438 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file network_admin_snapshot.cpp Binary snapshots of the game state for the admin network. */
+
+#include "../stdafx.h"
+#include "network_admin_snapshot.h"
+#include "network_internal.h"
+#include "../date_func.h"
+#include "../station_base.h"
+#include "../town.h"
+#include "../vehicle_base.h"
+#include "../worker_thread.h"
+#include "../linkgraph/linkgraph.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../safeguards.h"
+
+/** Copy of a primary vehicle. */
+struct AdminSnapshotVehicle {
+	VehicleID id;
+	VehicleType type;
+	Owner owner;
+	UnitID unitnumber;
+	TileIndex tile;
+	byte vehstatus;
+	uint16_t speed;
+	StationID last_station_visited;
+	uint32_t cargo;
+	uint32_t capacity;
+	Money profit_this_year;
+	Money value;
+};
+
+/** Copy of a station. */
+struct AdminSnapshotStation {
+	StationID id;
+	Owner owner;
+	TileIndex xy;
+	byte facilities;
+	uint32_t first_cargo; ///< First entry in AdminSnapshotData::cargo.
+	uint8_t cargo_count;  ///< Number of entries in AdminSnapshotData::cargo.
+};
+
+/** Copy of the waiting cargo of a station, or of the supplied cargo of a town. */
+struct AdminSnapshotCargo {
+	CargoID cargo;
+	uint8_t rating;  ///< Rating, for stations.
+	uint32_t amount; ///< Waiting cargo for stations, maximum amount of last month for towns.
+	uint32_t act;    ///< Transported cargo of last month, for towns.
+};
+
+/** Copy of a link graph edge. */
+struct AdminSnapshotLink {
+	StationID from;
+	StationID to;
+	CargoID cargo;
+	uint32_t capacity;
+	uint32_t usage;
+	uint32_t travel_time;
+};
+
+/** Copy of a town. */
+struct AdminSnapshotTown {
+	TownID id;
+	TileIndex xy;
+	uint32_t population;
+	uint32_t num_houses;
+	uint16_t growth_rate;
+	uint32_t first_cargo; ///< First entry in AdminSnapshotData::cargo.
+	uint8_t cargo_count;  ///< Number of entries in AdminSnapshotData::cargo.
+};
+
+/** Consistent copy of the game state, made on the main thread. */
+struct AdminSnapshotData {
+	std::shared_ptr<AdminSnapshotEncoder> encoder;
+	uint32_t sequence;
+	uint32_t generation;
+	bool full;
+	uint32_t date;
+	uint32_t frame;
+
+	std::vector<AdminSnapshotVehicle> vehicles;
+	std::vector<AdminSnapshotStation> stations;
+	std::vector<AdminSnapshotLink> links;
+	std::vector<AdminSnapshotTown> towns;
+	std::vector<AdminSnapshotCargo> cargo;
+
+	void Collect();
+};
+
+/** Copy the state of the vehicles, stations, links and towns. */
+void AdminSnapshotData::Collect()
+{
+	this->date = CalTime::CurDate().base();
+	this->frame = _frame_counter;
+
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		if (!v->IsPrimaryVehicle()) continue;
+
+		AdminSnapshotVehicle &sv = this->vehicles.emplace_back();
+		sv.id = v->index;
+		sv.type = v->type;
+		sv.owner = v->owner;
+		sv.unitnumber = v->unitnumber;
+		sv.tile = v->tile;
+		sv.vehstatus = v->vehstatus;
+		sv.speed = static_cast<uint16_t>(v->GetDisplaySpeed());
+		sv.last_station_visited = v->last_station_visited;
+		sv.cargo = 0;
+		sv.capacity = 0;
+		for (const Vehicle *u = v; u != nullptr; u = u->Next()) {
+			sv.cargo += u->cargo.StoredCount();
+			sv.capacity += u->cargo_cap;
+		}
+		sv.profit_this_year = v->GetDisplayProfitThisYear();
+		sv.value = v->value;
+	}
+
+	for (const Station *st : Station::Iterate()) {
+		AdminSnapshotStation &ss = this->stations.emplace_back();
+		ss.id = st->index;
+		ss.owner = st->owner;
+		ss.xy = st->xy;
+		ss.facilities = st->facilities;
+		ss.first_cargo = static_cast<uint32_t>(this->cargo.size());
+		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			const GoodsEntry &ge = st->goods[c];
+			uint waiting = ge.CargoTotalCount();
+			if (!HasBit(ge.status, GoodsEntry::GES_RATING) && waiting == 0) continue;
+			this->cargo.push_back({ c, ge.rating, waiting, 0 });
+		}
+		ss.cargo_count = static_cast<uint8_t>(this->cargo.size() - ss.first_cargo);
+	}
+
+	for (const LinkGraph *lg : LinkGraph::Iterate()) {
+		for (const auto &it : lg->GetEdges()) {
+			if (it.first.first == it.first.second || it.second.capacity == 0) continue;
+
+			AdminSnapshotLink &sl = this->links.emplace_back();
+			sl.from = (*lg)[it.first.first].Station();
+			sl.to = (*lg)[it.first.second].Station();
+			sl.cargo = lg->Cargo();
+			sl.capacity = it.second.capacity;
+			sl.usage = it.second.usage;
+			sl.travel_time = static_cast<uint32_t>(it.second.travel_time_sum / it.second.capacity);
+		}
+	}
+
+	for (const Town *t : Town::Iterate()) {
+		AdminSnapshotTown &stn = this->towns.emplace_back();
+		stn.id = t->index;
+		stn.xy = t->xy;
+		stn.population = t->cache.population;
+		stn.num_houses = t->cache.num_houses;
+		stn.growth_rate = t->growth_rate;
+		stn.first_cargo = static_cast<uint32_t>(this->cargo.size());
+		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			const auto &supplied = t->supplied[c];
+			if (supplied.old_max == 0) continue;
+			this->cargo.push_back({ c, 0, supplied.old_max, supplied.old_act });
+		}
+		stn.cargo_count = static_cast<uint8_t>(this->cargo.size() - stn.first_cargo);
+	}
+}
+
+/** Size of the key at the start of the records of each section. */
+static const size_t _admin_snapshot_key_size[ADMIN_SNAPSHOT_END] = {
+	0, ///< ADMIN_SNAPSHOT_BEGIN
+	4, ///< ADMIN_SNAPSHOT_VEHICLES
+	2, ///< ADMIN_SNAPSHOT_STATIONS
+	5, ///< ADMIN_SNAPSHOT_LINKS
+	2, ///< ADMIN_SNAPSHOT_TOWNS
+};
+
+/**
+ * Serialise the records of a section, and sort them by key.
+ * @param section The section to serialise.
+ * @param data The copy of the game state.
+ * @return The records.
+ */
+static AdminSnapshotRecords SerialiseAdminSnapshotSection(AdminSnapshotSection section, const AdminSnapshotData &data)
+{
+	AdminSnapshotRecords records;
+	BufferSerialiser buffer(records.data);
+
+	auto send_cargo = [&](uint32_t first, uint8_t count, bool town) {
+		buffer.Send_uint8(count);
+		for (uint32_t i = first; i < first + count; i++) {
+			const AdminSnapshotCargo &sc = data.cargo[i];
+			buffer.Send_uint8(sc.cargo);
+			if (town) {
+				buffer.Send_uint32(sc.amount);
+				buffer.Send_uint32(sc.act);
+			} else {
+				buffer.Send_uint8(sc.rating);
+				buffer.Send_uint32(sc.amount);
+			}
+		}
+	};
+
+	switch (section) {
+		case ADMIN_SNAPSHOT_VEHICLES:
+			for (const AdminSnapshotVehicle &sv : data.vehicles) {
+				records.offsets.push_back(static_cast<uint32_t>(records.data.size()));
+				buffer.Send_uint32(sv.id);
+				buffer.Send_uint8(sv.type);
+				buffer.Send_uint8(sv.owner);
+				buffer.Send_uint16(sv.unitnumber);
+				buffer.Send_uint32(sv.tile);
+				buffer.Send_uint8(sv.vehstatus);
+				buffer.Send_uint16(sv.speed);
+				buffer.Send_uint16(sv.last_station_visited);
+				buffer.Send_uint32(sv.cargo);
+				buffer.Send_uint32(sv.capacity);
+				buffer.Send_uint64(sv.profit_this_year);
+				buffer.Send_uint64(sv.value);
+			}
+			break;
+
+		case ADMIN_SNAPSHOT_STATIONS:
+			for (const AdminSnapshotStation &ss : data.stations) {
+				records.offsets.push_back(static_cast<uint32_t>(records.data.size()));
+				buffer.Send_uint16(ss.id);
+				buffer.Send_uint8(ss.owner);
+				buffer.Send_uint32(ss.xy);
+				buffer.Send_uint8(ss.facilities);
+				send_cargo(ss.first_cargo, ss.cargo_count, false);
+			}
+			break;
+
+		case ADMIN_SNAPSHOT_LINKS:
+			for (const AdminSnapshotLink &sl : data.links) {
+				records.offsets.push_back(static_cast<uint32_t>(records.data.size()));
+				buffer.Send_uint16(sl.from);
+				buffer.Send_uint16(sl.to);
+				buffer.Send_uint8(sl.cargo);
+				buffer.Send_uint32(sl.capacity);
+				buffer.Send_uint32(sl.usage);
+				buffer.Send_uint32(sl.travel_time);
+			}
+			break;
+
+		case ADMIN_SNAPSHOT_TOWNS:
+			for (const AdminSnapshotTown &stn : data.towns) {
+				records.offsets.push_back(static_cast<uint32_t>(records.data.size()));
+				buffer.Send_uint16(stn.id);
+				buffer.Send_uint32(stn.xy);
+				buffer.Send_uint32(stn.population);
+				buffer.Send_uint32(stn.num_houses);
+				buffer.Send_uint16(stn.growth_rate);
+				send_cargo(stn.first_cargo, stn.cargo_count, true);
+			}
+			break;
+
+		default: NOT_REACHED();
+	}
+	records.offsets.push_back(static_cast<uint32_t>(records.data.size()));
+
+	/* Order the records by the bytes of their key, so they can be merged with the previous snapshot. */
+	const size_t key_size = _admin_snapshot_key_size[section];
+	std::vector<uint32_t> order(records.Count());
+	for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+	auto key_less = [&](uint32_t a, uint32_t b) {
+		return memcmp(records.data.data() + records.offsets[a], records.data.data() + records.offsets[b], key_size) < 0;
+	};
+	if (std::is_sorted(order.begin(), order.end(), key_less)) return records;
+
+	std::sort(order.begin(), order.end(), key_less);
+	AdminSnapshotRecords sorted;
+	sorted.data.reserve(records.data.size());
+	sorted.offsets.reserve(records.offsets.size());
+	for (uint32_t i : order) {
+		sorted.offsets.push_back(static_cast<uint32_t>(sorted.data.size()));
+		sorted.data.insert(sorted.data.end(), records.data.begin() + records.offsets[i], records.data.begin() + records.offsets[i + 1]);
+	}
+	sorted.offsets.push_back(static_cast<uint32_t>(sorted.data.size()));
+	return sorted;
+}
+
+/** Writer of the packets of one section of a snapshot. */
+struct AdminSnapshotPacketWriter {
+	std::vector<std::unique_ptr<Packet>> &packets;
+	uint32_t sequence;
+	AdminSnapshotSection section;
+	std::unique_ptr<Packet> current;
+
+	AdminSnapshotPacketWriter(std::vector<std::unique_ptr<Packet>> &packets, uint32_t sequence, AdminSnapshotSection section) :
+			packets(packets), sequence(sequence), section(section) {}
+
+	/** Finish the current packet, if any. */
+	void Flush()
+	{
+		if (this->current == nullptr) return;
+		this->current->Send_uint8(ADMIN_SNAPSHOT_OP_END);
+		this->packets.push_back(std::move(this->current));
+	}
+
+	/**
+	 * Add an operation to the section.
+	 * @param op The operation.
+	 * @param data Start of the record or key.
+	 * @param size Size of the record or key.
+	 */
+	void Add(AdminSnapshotOperation op, const byte *data, size_t size)
+	{
+		/* Keep space for the operation and for the end marker. */
+		if (this->current != nullptr && !this->current->CanWriteToPacket(size + 2)) this->Flush();
+		if (this->current == nullptr) {
+			this->current = std::make_unique<Packet>(ADMIN_PACKET_SERVER_SNAPSHOT);
+			this->current->Send_uint32(this->sequence);
+			this->current->Send_uint8(this->section);
+		}
+		this->current->Send_uint8(op);
+		this->current->Send_binary(data, size);
+	}
+};
+
+/**
+ * Job to serialise a snapshot and encode it into packets, relative to the previous snapshot.
+ * @param data1 The AdminSnapshotData to encode, owned by this job.
+ */
+/* static */ void AdminSnapshotEncoder::EncodeJob(void *data1, void *, void *)
+{
+	std::unique_ptr<AdminSnapshotData> data(static_cast<AdminSnapshotData *>(data1));
+	AdminSnapshotEncoder *encoder = data->encoder.get();
+	std::vector<std::unique_ptr<Packet>> packets;
+
+	auto p = std::make_unique<Packet>(ADMIN_PACKET_SERVER_SNAPSHOT);
+	p->Send_uint32(data->sequence);
+	p->Send_uint8(ADMIN_SNAPSHOT_BEGIN);
+	p->Send_bool(data->full);
+	p->Send_uint32(data->date);
+	p->Send_uint32(data->frame);
+	packets.push_back(std::move(p));
+
+	for (AdminSnapshotSection section : { ADMIN_SNAPSHOT_VEHICLES, ADMIN_SNAPSHOT_STATIONS, ADMIN_SNAPSHOT_LINKS, ADMIN_SNAPSHOT_TOWNS }) {
+		AdminSnapshotRecords current = SerialiseAdminSnapshotSection(section, *data);
+		AdminSnapshotRecords &previous = encoder->previous[section];
+		if (data->full) previous = {};
+
+		const size_t key_size = _admin_snapshot_key_size[section];
+		AdminSnapshotPacketWriter writer(packets, data->sequence, section);
+
+		/* Merge the sorted records of both snapshots, and only write the differences. */
+		size_t i = 0;
+		size_t j = 0;
+		while (i < current.Count() || j < previous.Count()) {
+			const byte *cur = i < current.Count() ? current.data.data() + current.offsets[i] : nullptr;
+			const byte *prev = j < previous.Count() ? previous.data.data() + previous.offsets[j] : nullptr;
+			int cmp = (cur == nullptr) ? 1 : (prev == nullptr ? -1 : memcmp(cur, prev, key_size));
+			if (cmp < 0) {
+				writer.Add(ADMIN_SNAPSHOT_OP_UPDATE, cur, current.offsets[i + 1] - current.offsets[i]);
+				i++;
+			} else if (cmp > 0) {
+				writer.Add(ADMIN_SNAPSHOT_OP_REMOVE, prev, key_size);
+				j++;
+			} else {
+				size_t cur_size = current.offsets[i + 1] - current.offsets[i];
+				size_t prev_size = previous.offsets[j + 1] - previous.offsets[j];
+				if (cur_size != prev_size || memcmp(cur, prev, cur_size) != 0) writer.Add(ADMIN_SNAPSHOT_OP_UPDATE, cur, cur_size);
+				i++;
+				j++;
+			}
+		}
+		writer.Flush();
+
+		previous = std::move(current);
+	}
+
+	p = std::make_unique<Packet>(ADMIN_PACKET_SERVER_SNAPSHOT);
+	p->Send_uint32(data->sequence);
+	p->Send_uint8(ADMIN_SNAPSHOT_END);
+	packets.push_back(std::move(p));
+
+	std::lock_guard<std::mutex> guard(encoder->lock);
+	encoder->packets = std::move(packets);
+	encoder->finished_generation = data->generation;
+	encoder->busy = false;
+}
+
+/**
+ * Start a snapshot, unless the previous one is still being encoded or was started too recently.
+ * The game state is copied straight away, so this must be called from the main thread.
+ * @param full Whether to send a full snapshot, instead of the changes since the previous snapshot.
+ * @param min_interval Minimum time since the start of the previous snapshot.
+ * @return True if the snapshot was started.
+ */
+bool AdminSnapshotEncoder::Start(bool full, std::chrono::milliseconds min_interval)
+{
+	auto now = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		if (this->busy || !this->packets.empty()) return false;
+		if (this->sequence != 0 && now < this->last_start + min_interval) return false;
+		this->busy = true;
+	}
+	this->last_start = now;
+
+	std::unique_ptr<AdminSnapshotData> data = std::make_unique<AdminSnapshotData>();
+	data->encoder = this->shared_from_this();
+	data->sequence = ++this->sequence;
+	data->generation = this->generation;
+	data->full = full || this->need_full;
+	data->Collect();
+	this->need_full = false;
+
+	_general_worker_pool.EnqueueJob(&AdminSnapshotEncoder::EncodeJob, data.release());
+	return true;
+}
+
+/** Forget the previous snapshot, e.g. because a new game has been loaded. */
+void AdminSnapshotEncoder::Reset()
+{
+	this->generation++;
+	this->need_full = true;
+}
+
+/**
+ * Get the packets of the last snapshot, once it has been encoded.
+ * @return The packets, or nothing when no snapshot is ready.
+ */
+std::vector<std::unique_ptr<Packet>> AdminSnapshotEncoder::TakePackets()
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+	std::vector<std::unique_ptr<Packet>> result = std::move(this->packets);
+	this->packets.clear();
+
+	/* Drop snapshots of a previous game. */
+	if (this->finished_generation != this->generation) result.clear();
+	return result;
+}
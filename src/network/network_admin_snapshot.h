@@ -0,0 +1,64 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file network_admin_snapshot.h Binary snapshots of the game state for the admin network. */
+
+#ifndef NETWORK_ADMIN_SNAPSHOT_H
+#define NETWORK_ADMIN_SNAPSHOT_H
+
+#include "core/tcp_admin.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** Serialised records of one section of a snapshot, sorted by their key. */
+struct AdminSnapshotRecords {
+	std::vector<byte> data;        ///< The serialised records.
+	std::vector<uint32_t> offsets; ///< Start of each record in #data, followed by the end of the last record.
+
+	size_t Count() const { return this->offsets.empty() ? 0 : this->offsets.size() - 1; }
+};
+
+/**
+ * The snapshots sent to one admin.
+ * The game state is copied on the main thread, after which a worker thread serialises it and encodes the
+ * differences to the previous snapshot sent to the same admin.
+ */
+class AdminSnapshotEncoder : public std::enable_shared_from_this<AdminSnapshotEncoder> {
+	std::mutex lock;                                    ///< Lock for the members shared with the worker thread.
+	bool busy = false;                                  ///< Whether a snapshot is being encoded.
+	uint32_t finished_generation = 0;                   ///< Generation of the game the finished packets are for.
+	std::vector<std::unique_ptr<Packet>> packets;       ///< Encoded packets, waiting to be queued on the admin socket.
+
+	AdminSnapshotRecords previous[ADMIN_SNAPSHOT_END];  ///< The previous snapshot per section, only accessed by the encoding job.
+
+	uint32_t sequence = 0;                              ///< Number of the last started snapshot.
+	uint32_t generation = 0;                            ///< Generation of the game, changed when a new game is loaded.
+	bool need_full = true;                              ///< Whether the next snapshot may not be a delta.
+	std::chrono::steady_clock::time_point last_start;   ///< When the last snapshot was started.
+
+	static void EncodeJob(void *data1, void *data2, void *data3);
+
+public:
+	bool Start(bool full, std::chrono::milliseconds min_interval);
+	void Reset();
+	std::vector<std::unique_ptr<Packet>> TakePackets();
+
+	/**
+	 * Whether a snapshot is being encoded.
+	 * @return True if the encoding job has not finished yet.
+	 */
+	bool IsBusy()
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		return this->busy;
+	}
+};
+
+#endif /* NETWORK_ADMIN_SNAPSHOT_H */
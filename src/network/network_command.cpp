@@ -191,18 +191,24 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	/* The command is the same for all clients except the owner, so encode it only once for them. */
+	SharedPacket shared_packet;
+
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
 		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
 			cp.callback = (cs != owner) ? nullptr : callback;
 			cp.my_cmd = (cs == owner);
+			if (cs != owner && shared_packet == nullptr) shared_packet = PrepareSharedPacket(cs->CreateCommandPacket(cp));
+			cp.shared_packet = (cs != owner) ? shared_packet : nullptr;
 			cs->outgoing_queue.push_back(cp);
 		}
 	}
 
 	cp.callback = (nullptr != owner) ? nullptr : callback;
 	cp.my_cmd = (nullptr == owner);
+	cp.shared_packet = nullptr;
 	_local_execution_queue.push_back(cp);
 }
 
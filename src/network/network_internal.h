@@ -128,6 +128,7 @@ struct CommandPacket : CommandContainer {
 	ClientID client_id;  ///< originating client ID (or INVALID_CLIENT_ID if not specified)
 	CompanyID company;   ///< company that is executing the command
 	bool my_cmd;         ///< did the command originate from "me"
+	SharedPacket shared_packet; ///< the command encoded for sending, shared between the clients it is sent to, or nullptr
 };
 
 void NetworkDistributeCommands();
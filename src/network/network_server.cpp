@@ -689,36 +689,59 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Tell the client that they may run to a particular frame. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+/**
+ * Tell the client that they may run to a particular frame.
+ * @param shared If not nullptr, cache of the frame packet without a new token, to share it with the other clients this tick.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(SharedPacket *shared)
 {
-	auto p = std::make_unique<Packet>(PACKET_SERVER_FRAME, TCP_MTU);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_frame_counter_max);
+	auto create_packet = []() {
+		auto p = std::make_unique<Packet>(PACKET_SERVER_FRAME, TCP_MTU);
+		p->Send_uint32(_frame_counter);
+		p->Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
-	p->Send_uint32(_sync_seed_1);
-	p->Send_uint64(_sync_state_checksum);
+		p->Send_uint32(_sync_seed_1);
+		p->Send_uint64(_sync_state_checksum);
 #endif
+		return p;
+	};
 
 	/* If token equals 0, we need to make a new token and send that. */
 	if (this->last_token == 0) {
+		auto p = create_packet();
 		this->last_token = InteractiveRandomRange(UINT8_MAX - 1) + 1;
 		p->Send_uint8(this->last_token);
+		this->SendPacket(std::move(p));
+	} else if (shared != nullptr) {
+		if (*shared == nullptr) *shared = PrepareSharedPacket(create_packet());
+		this->SendPacket(*shared);
+	} else {
+		this->SendPacket(create_packet());
 	}
-
-	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Request the client to sync. */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+/**
+ * Request the client to sync.
+ * @param shared If not nullptr, cache of the sync packet, to share it with the other clients this tick.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync(SharedPacket *shared)
 {
-	auto p = std::make_unique<Packet>(PACKET_SERVER_SYNC, TCP_MTU);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_sync_seed_1);
+	auto create_packet = []() {
+		auto p = std::make_unique<Packet>(PACKET_SERVER_SYNC, TCP_MTU);
+		p->Send_uint32(_frame_counter);
+		p->Send_uint32(_sync_seed_1);
 
-	p->Send_uint64(_sync_state_checksum);
-	this->SendPacket(std::move(p));
+		p->Send_uint64(_sync_state_checksum);
+		return p;
+	};
+
+	if (shared != nullptr) {
+		if (*shared == nullptr) *shared = PrepareSharedPacket(create_packet());
+		this->SendPacket(*shared);
+	} else {
+		this->SendPacket(create_packet());
+	}
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -727,15 +750,29 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
  * @param cp The command to send.
  */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket &cp)
+{
+	if (cp.shared_packet != nullptr) {
+		/* Already encoded when it was distributed to all clients. */
+		this->SendPacket(cp.shared_packet);
+	} else {
+		this->SendPacket(this->CreateCommandPacket(cp));
+	}
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Create the packet to send a command to a client.
+ * @param cp The command to send.
+ * @return The packet.
+ */
+std::unique_ptr<Packet> ServerNetworkGameSocketHandler::CreateCommandPacket(const CommandPacket &cp)
 {
 	auto p = std::make_unique<Packet>(PACKET_SERVER_COMMAND, TCP_MTU);
 
 	this->NetworkGameSocketHandler::SendCommand(*p, cp);
 	p->Send_uint32(cp.frame);
 	p->Send_bool  (cp.my_cmd);
-
-	this->SendPacket(std::move(p));
-	return NETWORK_RECV_STATUS_OKAY;
+	return p;
 }
 
 /**
@@ -1973,6 +2010,9 @@ void NetworkServer_Tick(bool send_frame)
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 	bool send_sync = false;
 #endif
+	/* The frame and sync packets are the same for all clients, so only create them once. */
+	SharedPacket frame_packet;
+	SharedPacket sync_packet;
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 	if (_frame_counter >= _last_sync_frame + _settings_client.network.sync_freq) {
@@ -2094,11 +2134,11 @@ void NetworkServer_Tick(bool send_frame)
 			NetworkHandleCommandQueue(cs);
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(&frame_packet);
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
-			if (send_sync) cs->SendSync();
+			if (send_sync) cs->SendSync(&sync_packet);
 #endif
 		}
 	}
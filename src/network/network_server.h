@@ -119,9 +119,10 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, const std::string &msg, NetworkTextMessageData data);
 	NetworkRecvStatus SendExternalChat(const std::string &source, TextColour colour, const std::string &user, const std::string &msg);
 	NetworkRecvStatus SendJoin(ClientID client_id);
-	NetworkRecvStatus SendFrame();
-	NetworkRecvStatus SendSync();
+	NetworkRecvStatus SendFrame(SharedPacket *shared = nullptr);
+	NetworkRecvStatus SendSync(SharedPacket *shared = nullptr);
 	NetworkRecvStatus SendCommand(const CommandPacket &cp);
+	std::unique_ptr<Packet> CreateCommandPacket(const CommandPacket &cp);
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 	NetworkRecvStatus SendSettingsAccessUpdate(bool ok);
@@ -13,6 +13,7 @@
 
 #include "newgrf_internal.h"
 #include "core/container_func.hpp"
+#include "core/serialisation.hpp"
 #include "debug.h"
 #include "fileio_func.h"
 #include "engine_func.h"
@@ -54,12 +55,16 @@
 #include "road.h"
 #include "newgrf_roadstop.h"
 #include "debug_settings.h"
+#include "worker_thread.h"
 
 #include "table/strings.h"
 #include "table/build_industry.h"
 
 #include "3rdparty/cpp-btree/btree_map.h"
 
+#include <chrono>
+#include <unordered_map>
+
 #include "safeguards.h"
 
 /* TTDPatch extended GRF format codec
@@ -5783,7 +5788,7 @@ static const SpriteGroup *CreateGroupFromGroupID(byte feature, uint16_t setid, b
 	return new ResultSpriteGroup(spriteset_start, num_sprites);
 }
 
-static void ProcessDeterministicSpriteGroupRanges(const std::vector<DeterministicSpriteGroupRange> &ranges, std::vector<DeterministicSpriteGroupRange> &ranges_out, const SpriteGroup *default_group)
+static void ProcessDeterministicSpriteGroupRanges(const SpriteGroupVector<DeterministicSpriteGroupRange> &ranges, SpriteGroupVector<DeterministicSpriteGroupRange> &ranges_out, const SpriteGroup *default_group)
 {
 	/* Sort ranges ascending. When ranges overlap, this may required clamping or splitting them */
 	std::vector<uint32_t> bounds;
@@ -5984,7 +5989,7 @@ static void NewSpriteGroup(ByteReader *buf)
 			if (unlikely(HasBit(_misc_debug_flags, MDF_NEWGRF_SG_SAVE_RAW))) {
 				shadow = &(_deterministic_sg_shadows[group]);
 			}
-			static std::vector<DeterministicSpriteGroupAdjust> current_adjusts;
+			static SpriteGroupVector<DeterministicSpriteGroupAdjust> current_adjusts;
 			current_adjusts.clear();
 
 			VarAction2OptimiseState va2_opt_state;
@@ -6066,7 +6071,7 @@ static void NewSpriteGroup(ByteReader *buf)
 				OptimiseVarAction2Adjust(va2_opt_state, info, group, group->adjusts.back());
 			}
 
-			std::vector<DeterministicSpriteGroupRange> ranges;
+			SpriteGroupVector<DeterministicSpriteGroupRange> ranges;
 			ranges.resize(buf->ReadByte());
 			for (uint i = 0; i < ranges.size(); i++) {
 				ranges[i].group = GetGroupFromGroupID(setid, type, buf->ReadWord());
@@ -10514,6 +10519,7 @@ void ResetNewGRFData()
 
 	InitializeSoundPool();
 	_spritegroup_pool.CleanPool();
+	ResetSpriteGroupArenas();
 	_callback_result_cache.clear();
 	_deterministic_sg_shadows.clear();
 	_randomized_sg_shadows.clear();
@@ -11204,8 +11210,10 @@ static void FinaliseAirportsArray()
  * partial implementation yet).
  * XXX: We consider GRF files trusted. It would be trivial to exploit OTTD by
  * a crafted invalid GRF file. We should tell that to the user somehow, or
- * better make this more robust in the future. */
-static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
+ * better make this more robust in the future.
+ * When read_ahead is set, buf already contains the pseudo sprite content and the
+ * file is positioned after it. */
+static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage, bool read_ahead = false)
 {
 	/* XXX: There is a difference between staged loading in TTDPatch and
 	 * here.  In TTDPatch, for some reason actions 1 and 2 are carried out
@@ -11250,14 +11258,14 @@ static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
 	if (it == _grf_line_to_action6_sprite_override.end()) {
 		/* No preloaded sprite to work with; read the
 		 * pseudo sprite content. */
-		_cur.file->ReadBlock(buf, num);
+		if (!read_ahead) _cur.file->ReadBlock(buf, num);
 	} else {
 		/* Use the preloaded sprite data. */
 		buf = it->second.get();
 		grfmsg(7, "DecodeSpecialSprite: Using preloaded pseudo sprite data");
 
 		/* Skip the real (original) content of this action. */
-		_cur.file->SeekTo(num, SEEK_CUR);
+		if (!read_ahead) _cur.file->SeekTo(num, SEEK_CUR);
 	}
 
 	ByteReader br(buf, buf + num);
@@ -11284,6 +11292,296 @@ static void DecodeSpecialSprite(byte *buf, uint num, GrfLoadingStage stage)
 	}
 }
 
+/** Read ahead files of the NewGRFs being loaded by LoadNewGRF. */
+static std::unordered_map<const GRFConfig *, NewGRFReadAheadFile> _grf_read_ahead;
+
+/** Identifier at the start of a NewGRF read ahead cache file. */
+static const uint32_t NEWGRF_READ_AHEAD_CACHE_MAGIC = 0x41524747; // 'GGRA'
+/** Version of the format of the NewGRF read ahead cache files. */
+static const uint32_t NEWGRF_READ_AHEAD_CACHE_VERSION = 2;
+
+/**
+ * Load the records from the cache file.
+ * The cache is only used when it was written by the same version of the game, for a file with the same MD5 checksum and size,
+ * and when the MD5 checksum of the records matches the one stored with them, so a corrupted cache does not change the NewGRF.
+ * Only the records are cached, the actions and the optimisation of the sprite groups still run on every load.
+ * @param file_size Size of the NewGRF file.
+ * @return True if the records were loaded.
+ */
+bool NewGRFReadAheadFile::LoadCache(size_t file_size)
+{
+	std::vector<byte> buffer;
+	{
+		std::unique_ptr<FILE, FileDeleter> fp(fopen(this->cache_filename.c_str(), "rb"));
+		if (fp == nullptr) return false;
+		if (fseek(fp.get(), 0, SEEK_END) != 0) return false;
+		long size = ftell(fp.get());
+		if (size <= 0 || fseek(fp.get(), 0, SEEK_SET) != 0) return false;
+		buffer.resize(size);
+		if (fread(buffer.data(), 1, buffer.size(), fp.get()) != buffer.size()) return false;
+	}
+
+	BufferDeserialiser reader(buffer);
+	if (reader.Recv_uint32() != NEWGRF_READ_AHEAD_CACHE_MAGIC || reader.Recv_uint32() != NEWGRF_READ_AHEAD_CACHE_VERSION) return false;
+	if (reader.Recv_string(256) != _openttd_revision) return false;
+	std::span<const uint8_t> md5sum = reader.Recv_binary_view(this->md5sum.size());
+	if (reader.error || !std::equal(md5sum.begin(), md5sum.end(), this->md5sum.begin())) return false;
+	if (reader.Recv_uint64() != file_size) return false;
+
+	std::span<const uint8_t> records_md5sum = reader.Recv_binary_view(MD5_HASH_BYTES);
+	if (reader.error) return false;
+	MD5Hash actual_records_md5sum;
+	Md5 checksum;
+	checksum.Append(buffer.data() + reader.pos, reader.size - reader.pos);
+	checksum.Finish(actual_records_md5sum);
+	if (!std::equal(records_md5sum.begin(), records_md5sum.end(), actual_records_md5sum.begin())) return false;
+
+	this->start_pos = reader.Recv_uint64();
+	this->end_pos = reader.Recv_uint64();
+	uint32_t count = reader.Recv_uint32();
+	if (reader.error || count > file_size) return false;
+
+	size_t pos = this->start_pos;
+	this->sprites.resize(count);
+	for (NewGRFReadAheadSprite &sprite : this->sprites) {
+		sprite.start_pos = reader.Recv_uint64();
+		sprite.end_pos = reader.Recv_uint64();
+		sprite.num = reader.Recv_uint32();
+		sprite.data_offset = reader.Recv_uint32();
+		sprite.type = reader.Recv_uint8();
+		if (sprite.start_pos != pos || sprite.end_pos <= sprite.start_pos) return false;
+		pos = sprite.end_pos;
+	}
+	if (pos != this->end_pos || this->end_pos > file_size) return false;
+
+	uint32_t data_size = reader.Recv_uint32();
+	if (reader.error || !reader.CanRecvBytes(data_size, false)) return false;
+	for (const NewGRFReadAheadSprite &sprite : this->sprites) {
+		if (sprite.type == 0xFF && (sprite.data_offset > data_size || sprite.num > data_size - sprite.data_offset)) return false;
+	}
+	std::span<const uint8_t> data = reader.Recv_binary_view(data_size);
+	this->data.assign(data.begin(), data.end());
+
+	return !reader.error && reader.pos == reader.size;
+}
+
+/**
+ * Write the records to the cache file.
+ * @param file_size Size of the NewGRF file.
+ */
+void NewGRFReadAheadFile::SaveCache(size_t file_size) const
+{
+	std::vector<byte> buffer;
+	BufferSerialiser writer(buffer);
+	writer.Send_uint32(NEWGRF_READ_AHEAD_CACHE_MAGIC);
+	writer.Send_uint32(NEWGRF_READ_AHEAD_CACHE_VERSION);
+	writer.Send_string(_openttd_revision);
+	writer.Send_binary(this->md5sum.data(), this->md5sum.size());
+	writer.Send_uint64(file_size);
+
+	std::vector<byte> records;
+	BufferSerialiser records_writer(records);
+	records_writer.Send_uint64(this->start_pos);
+	records_writer.Send_uint64(this->end_pos);
+	records_writer.Send_uint32(static_cast<uint32_t>(this->sprites.size()));
+	for (const NewGRFReadAheadSprite &sprite : this->sprites) {
+		records_writer.Send_uint64(sprite.start_pos);
+		records_writer.Send_uint64(sprite.end_pos);
+		records_writer.Send_uint32(sprite.num);
+		records_writer.Send_uint32(sprite.data_offset);
+		records_writer.Send_uint8(sprite.type);
+	}
+	records_writer.Send_uint32(static_cast<uint32_t>(this->data.size()));
+	records_writer.Send_binary(this->data.data(), this->data.size());
+
+	MD5Hash records_md5sum;
+	Md5 checksum;
+	checksum.Append(records.data(), records.size());
+	checksum.Finish(records_md5sum);
+	writer.Send_binary(records_md5sum.data(), records_md5sum.size());
+	writer.Send_binary(records.data(), records.size());
+
+	if (!FioReplaceFile(this->cache_filename, buffer.data(), buffer.size())) {
+		DEBUG(grf, 1, "Could not write NewGRF read ahead cache file %s", this->cache_filename.c_str());
+	}
+}
+
+/**
+ * Read the sprite records of the file, this does not touch any global state, so can be run on a worker thread.
+ * Real sprites are skipped, but their positions are kept so that they need not be parsed again in each loading stage.
+ * When a cache file is given, the records are loaded from it if it is valid, and otherwise written to it.
+ */
+void NewGRFReadAheadFile::Read()
+{
+	auto start = std::chrono::steady_clock::now();
+
+	if (!this->cache_filename.empty()) {
+		size_t file_size;
+		FILE *f = FioFOpenFile(this->filename, "rb", this->subdir, &file_size);
+		if (f == nullptr) return;
+		FioFCloseFile(f);
+
+		if (this->LoadCache(file_size)) {
+			this->valid = true;
+			this->from_cache = true;
+			this->read_time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+			return;
+		}
+		this->sprites.clear();
+		this->data.clear();
+
+		this->ReadFile();
+		if (this->valid) this->SaveCache(file_size);
+	} else {
+		this->ReadFile();
+	}
+
+	this->read_time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/** Read the sprite records from the NewGRF file itself. */
+void NewGRFReadAheadFile::ReadFile()
+{
+	SpriteFile file(this->filename, this->subdir, this->needs_palette_remap);
+	file.MapFile();
+	byte grf_container_version = file.GetContainerVersion();
+	if (grf_container_version == 0) return;
+
+	if (grf_container_version >= 2) {
+		/* Skip sprite section offset and read compression value. */
+		file.ReadDword();
+		if (file.ReadByte() != 0) return;
+	}
+
+	uint32_t num = grf_container_version >= 2 ? file.ReadDword() : file.ReadWord();
+	if (num != 4 || file.ReadByte() != 0xFF) return;
+	file.ReadDword();
+
+	this->start_pos = file.GetPos();
+	for (;;) {
+		NewGRFReadAheadSprite sprite;
+		sprite.start_pos = file.GetPos();
+		sprite.num = grf_container_version >= 2 ? file.ReadDword() : file.ReadWord();
+		if (sprite.num == 0) {
+			this->end_pos = sprite.start_pos;
+			break;
+		}
+		sprite.type = file.ReadByte();
+		sprite.data_offset = 0;
+
+		if (sprite.type == 0xFF) {
+			sprite.data_offset = static_cast<uint32_t>(this->data.size());
+			this->data.resize(this->data.size() + sprite.num);
+			file.ReadBlock(this->data.data() + sprite.data_offset, sprite.num);
+		} else if (grf_container_version >= 2 && sprite.type == 0xFD) {
+			/* Reference to data section. Container version >= 2 only. */
+			file.SkipBytes(sprite.num);
+		} else {
+			file.SkipBytes(7);
+			SkipSpriteData(file, sprite.type, sprite.num - 8);
+		}
+		sprite.end_pos = file.GetPos();
+		this->sprites.push_back(sprite);
+	}
+
+	this->valid = true;
+}
+
+/**
+ * Process the sprite records of the file in a loading stage, from the read ahead records instead of from the file.
+ * The file is kept positioned as if the records were read from it, so that actions which read from the file,
+ * or jump to labels, behave the same way.
+ * @param stage The loading stage.
+ * @param file The file, positioned at the first record.
+ * @param buf Buffer for the pseudo sprite content.
+ * @return False if an action moved the file to a position which is not the start of a record,
+ *         loading should then continue from the file.
+ */
+bool NewGRFReadAheadFile::Load(GrfLoadingStage stage, SpriteFile &file, ReusableBuffer<byte> &buf) const
+{
+	size_t index = 0;
+	while (index < this->sprites.size()) {
+		const NewGRFReadAheadSprite &sprite = this->sprites[index];
+		_cur.nfo_line++;
+
+		if (sprite.type == 0xFF) {
+			if (_cur.skip_sprites == 0) {
+				/* Actions may modify the content, so work on a copy. */
+				byte *content = buf.Allocate(sprite.num);
+				memcpy(content, this->data.data() + sprite.data_offset, sprite.num);
+				file.SeekTo(sprite.end_pos, SEEK_SET);
+				DecodeSpecialSprite(content, sprite.num, stage, true);
+
+				/* Stop all processing if we are to skip the remaining sprites */
+				if (_cur.skip_sprites == -1) return true;
+
+				size_t pos = file.GetPos();
+				if (pos == sprite.end_pos) {
+					index++;
+					continue;
+				}
+
+				/* The action read further sprites, or jumped to a label. */
+				if (pos == this->end_pos) return true;
+				auto it = std::lower_bound(this->sprites.begin(), this->sprites.end(), pos, [](const NewGRFReadAheadSprite &s, size_t pos) {
+					return s.start_pos < pos;
+				});
+				if (it == this->sprites.end() || it->start_pos != pos) return false;
+				index = it - this->sprites.begin();
+				continue;
+			}
+		} else if (_cur.skip_sprites == 0) {
+			grfmsg(0, "LoadNewGRFFile: Unexpected sprite, disabling");
+			DisableGrf(STR_NEWGRF_ERROR_UNEXPECTED_SPRITE);
+			return true;
+		}
+
+		if (_cur.skip_sprites > 0) _cur.skip_sprites--;
+		index++;
+	}
+	return true;
+}
+
+/**
+ * Read ahead the sprite records of all NewGRFs which are going to be loaded, in parallel on the worker threads.
+ * The actions are still applied one NewGRF at a time, in order, by the loading stages.
+ * @param num_baseset Number of NewGRFs at the front of the list to look up in the baseset dir instead of the newgrf dir.
+ */
+static void ReadAheadNewGRFFiles(uint num_baseset)
+{
+	std::string cache_dir;
+	if (_settings_client.gui.newgrf_read_ahead_cache && !_personal_dir.empty()) {
+		cache_dir = _personal_dir + "cache" PATHSEP;
+		FioCreateDirectory(cache_dir);
+		cache_dir += "newgrf" PATHSEP;
+		FioCreateDirectory(cache_dir);
+	}
+
+	std::vector<NewGRFReadAheadFile *> files;
+	uint num_grfs = 0;
+	for (const GRFConfig *c = _grfconfig; c != nullptr; c = c->next) {
+		if (c->status == GCS_DISABLED || c->status == GCS_NOT_FOUND) continue;
+
+		Subdirectory subdir = num_grfs < num_baseset ? BASESET_DIR : NEWGRF_DIR;
+		if (!FioCheckFileExists(c->filename, subdir)) continue;
+		num_grfs++;
+
+		NewGRFReadAheadFile &file = _grf_read_ahead[c];
+		file.filename = c->filename;
+		file.subdir = subdir;
+		file.needs_palette_remap = c->palette & GRFP_USE_MASK;
+		file.md5sum = c->ident.md5sum;
+		if (!cache_dir.empty() && c->ident.md5sum != MD5Hash{}) {
+			file.cache_filename = cache_dir + FormatArrayAsHex(c->ident.md5sum) + ".dat";
+		}
+		files.push_back(&file);
+	}
+
+	_general_worker_pool.ParallelFor(static_cast<uint>(files.size()), [&](uint i) {
+		files[i]->Read();
+	});
+}
+
 /**
  * Load a particular NewGRF from a SpriteFile.
  * @param config The configuration of the to be loaded NewGRF.
@@ -11336,6 +11634,12 @@ static void LoadNewGRFFileFromFile(GRFConfig *config, GrfLoadingStage stage, Spr
 
 	ReusableBuffer<byte> buf;
 
+	auto read_ahead = _grf_read_ahead.find(config);
+	if (read_ahead != _grf_read_ahead.end() && read_ahead->second.valid && read_ahead->second.start_pos == file.GetPos() &&
+			read_ahead->second.filename == file.GetFilename()) {
+		if (read_ahead->second.Load(stage, file, buf)) return;
+	}
+
 	while ((num = (grf_container_version >= 2 ? file.ReadDword() : file.ReadWord())) != 0) {
 		byte type = file.ReadByte();
 		_cur.nfo_line++;
@@ -11399,13 +11703,18 @@ void LoadNewGRFFile(GRFConfig *config, GrfLoadingStage stage, Subdirectory subdi
 		if (stage == GLS_ACTIVATION && !HasBit(config->flags, GCF_RESERVED)) return;
 	}
 
+	/* The file is only mapped while it is loaded; the sprite cache reads it through the buffer during the game,
+	 * so the file can be changed or replaced on disk while it is open. */
 	bool needs_palette_remap = config->palette & GRFP_USE_MASK;
 	if (temporary) {
 		SpriteFile temporarySpriteFile(filename, subdir, needs_palette_remap);
+		temporarySpriteFile.MapFile();
 		LoadNewGRFFileFromFile(config, stage, temporarySpriteFile);
 	} else {
 		SpriteFile &file = OpenCachedSpriteFile(filename, subdir, needs_palette_remap);
+		file.MapFile();
 		LoadNewGRFFileFromFile(config, stage, file);
+		file.UnmapFile();
 		if (!HasBit(config->flags, GCF_SYSTEM)) file.flags |= SFF_USERGRF;
 		if (config->ident.grfid == BSWAP32(0xFFFFFFFE)) file.flags |= SFF_OPENTTDGRF;
 	}
@@ -11753,6 +12062,10 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 
 	_cur.spriteid = load_index;
 
+	ReadAheadNewGRFFiles(num_baseset);
+
+	SpriteGroupFreezeStats freeze_total;
+
 	/* Load newgrf sprites
 	 * in each loading stage, (try to) open each file specified in the config
 	 * and load information from it. */
@@ -11789,7 +12102,14 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 				continue;
 			}
 
-			if (stage == GLS_LABELSCAN) InitNewGRFFile(c);
+			if (stage == GLS_LABELSCAN) {
+				InitNewGRFFile(c);
+				auto read_ahead = _grf_read_ahead.find(c);
+				if (read_ahead != _grf_read_ahead.end()) {
+					_cur.grffile->read_ahead_time = read_ahead->second.read_time;
+					_cur.grffile->read_ahead_from_cache = read_ahead->second.from_cache;
+				}
+			}
 
 			if (!HasBit(c->flags, GCF_STATIC) && !HasBit(c->flags, GCF_SYSTEM)) {
 				if (num_non_static == MAX_NON_STATIC_GRF_COUNT) {
@@ -11803,6 +12123,7 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 
 			num_grfs++;
 
+			auto load_start = std::chrono::steady_clock::now();
 			LoadNewGRFFile(c, stage, subdir, false);
 			if (stage == GLS_RESERVE) {
 				SetBit(c->flags, GCF_RESERVED);
@@ -11812,15 +12133,26 @@ void LoadNewGRF(uint load_index, uint num_baseset)
 				ClearTemporaryNewGRFData(_cur.grffile);
 				BuildCargoTranslationMap();
 				HandleVarAction2OptimisationPasses();
+				SpriteGroupFreezeStats freeze = FreezeSpriteGroups();
+				DEBUG(grf, 2, "LoadNewGRF: Moved data of %u sprite groups of '%s' into an arena, %u bytes before, %u bytes after",
+						(uint)freeze.groups, c->filename.c_str(), (uint)freeze.heap_bytes, (uint)freeze.arena_bytes);
+				freeze_total.groups += freeze.groups;
+				freeze_total.heap_bytes += freeze.heap_bytes;
+				freeze_total.arena_bytes += freeze.arena_bytes;
 				DEBUG(sprite, 2, "LoadNewGRF: Currently %i sprites are loaded", _cur.spriteid);
 			} else if (stage == GLS_INIT && HasBit(c->flags, GCF_INIT_ONLY)) {
 				/* We're not going to activate this, so free whatever data we allocated */
 				ClearTemporaryNewGRFData(_cur.grffile);
 			}
+			_cur.grffile->load_stage_time[stage] += static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - load_start).count());
 		}
 	}
 
+	DEBUG(grf, 1, "LoadNewGRF: Moved data of %u sprite groups into arenas, %u bytes before, %u bytes after",
+			(uint)freeze_total.groups, (uint)freeze_total.heap_bytes, (uint)freeze_total.arena_bytes);
+
 	/* Pseudo sprite processing is finished; free temporary stuff */
+	_grf_read_ahead.clear();
 	_cur.ClearDataForNextFile();
 	_callback_result_cache.clear();
 
@@ -394,6 +394,10 @@ struct GRFFile : ZeroedMemoryAllocator {
 
 	btree::btree_map<uint16_t, uint> string_map; ///< Map of local GRF string ID to string ID
 
+	uint32_t read_ahead_time;                ///< Time spent reading ahead the sprite records on a worker thread, in microseconds
+	bool read_ahead_from_cache;              ///< Whether the sprite records were loaded from the read ahead cache
+	uint32_t load_stage_time[GLS_END];       ///< Time spent on the main thread in each loading stage, in microseconds
+
 	GRFFile(const struct GRFConfig *config);
 	~GRFFile();
 
@@ -26,6 +26,7 @@
 
 #include "fileio_func.h"
 #include "fios.h"
+#include "scan_index.h"
 
 #include "thread.h"
 #include <mutex>
@@ -286,6 +287,8 @@ struct GRFMD5SumState {
 	GRFConfig *config;
 	size_t size;
 	FILE *f;
+	bool use_index;
+	ScanIndexKey index_key;
 };
 
 static uint _grf_md5_parallel = 0;
@@ -308,6 +311,7 @@ static void CalcGRFMD5SumFromState(const GRFMD5SumState &state)
 		checksum.Append(buffer, len);
 	}
 	checksum.Finish(state.config->ident.md5sum);
+	if (state.use_index) UpdateScanIndex(state.index_key, state.config->ident.md5sum);
 
 	FioFCloseFile(state.f);
 }
@@ -359,9 +363,10 @@ void CalcGRFMD5ThreadingEnd()
 static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 {
 	size_t size;
+	std::string path;
 
 	/* open the file */
-	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size);
+	FILE *f = FioFOpenFile(config->filename, "rb", subdir, &size, &path);
 	if (f == nullptr) return false;
 
 	long start = ftell(f);
@@ -372,8 +377,16 @@ static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 		return false;
 	}
 
+	/* Files which have not changed since the last scan need not be read again. */
+	ScanIndexKey index_key;
+	bool use_index = GetScanIndexKey(f, path, size, index_key);
+	if (use_index && LookupScanIndex(index_key, config->ident.md5sum)) {
+		FioFCloseFile(f);
+		return true;
+	}
+
 	/* calculate md5sum */
-	GRFMD5SumState state { config, size, f };
+	GRFMD5SumState state { config, size, f, use_index, std::move(index_key) };
 	if (_grf_md5_parallel == 0) {
 		CalcGRFMD5SumFromState(state);
 		return true;
@@ -641,6 +654,7 @@ public:
 		fs.grfs.clear();
 		int ret = fs.Scan(".grf", NEWGRF_DIR);
 		CalcGRFMD5ThreadingEnd();
+		SaveScanIndex();
 
 		for (GRFConfig *c : fs.grfs) {
 			bool added = true;
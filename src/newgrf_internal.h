@@ -16,9 +16,11 @@
 #include "newgrf_spritegroup.h"
 #include "spriteloader/spriteloader.hpp"
 #include "core/arena_alloc.hpp"
+#include "3rdparty/md5/md5.h"
 
 #include "3rdparty/cpp-btree/btree_map.h"
 #include <bitset>
+#include <string>
 #include <vector>
 
 /** Base GRF ID for OpenTTD's base graphics GRFs. */
@@ -72,8 +74,8 @@ public:
 	UniformArenaAllocator<sizeof(VarAction2GroupVariableTracking), 1024> group_temp_store_variable_tracking_storage;
 	btree::btree_map<const SpriteGroup *, VarAction2ProcedureAnnotation *> procedure_annotations;
 	UniformArenaAllocator<sizeof(VarAction2ProcedureAnnotation), 1024> procedure_annotations_storage;
-	btree::btree_map<const DeterministicSpriteGroup *, std::vector<DeterministicSpriteGroupAdjust> *> inlinable_adjust_groups;
-	UniformArenaAllocator<sizeof(std::vector<DeterministicSpriteGroupAdjust>), 1024> inlinable_adjust_groups_storage;
+	btree::btree_map<const DeterministicSpriteGroup *, SpriteGroupVector<DeterministicSpriteGroupAdjust> *> inlinable_adjust_groups;
+	UniformArenaAllocator<sizeof(SpriteGroupVector<DeterministicSpriteGroupAdjust>), 1024> inlinable_adjust_groups_storage;
 	std::vector<DeterministicSpriteGroup *> dead_store_elimination_candidates;
 
 	VarAction2GroupVariableTracking *GetVarAction2GroupVariableTracking(const SpriteGroup *group, bool make_new)
@@ -100,11 +102,11 @@ public:
 		}
 	}
 
-	std::vector<DeterministicSpriteGroupAdjust> *GetInlinableGroupAdjusts(const DeterministicSpriteGroup *group, bool make_new)
+	SpriteGroupVector<DeterministicSpriteGroupAdjust> *GetInlinableGroupAdjusts(const DeterministicSpriteGroup *group, bool make_new)
 	{
 		if (make_new) {
-			std::vector<DeterministicSpriteGroupAdjust> *&ptr = this->inlinable_adjust_groups[group];
-			if (!ptr) ptr = new (this->inlinable_adjust_groups_storage.Allocate()) std::vector<DeterministicSpriteGroupAdjust>();
+			SpriteGroupVector<DeterministicSpriteGroupAdjust> *&ptr = this->inlinable_adjust_groups[group];
+			if (!ptr) ptr = new (this->inlinable_adjust_groups_storage.Allocate()) SpriteGroupVector<DeterministicSpriteGroupAdjust>();
 			return ptr;
 		} else {
 			auto iter = this->inlinable_adjust_groups.find(group);
@@ -130,7 +132,7 @@ public:
 		this->procedure_annotations.clear();
 		this->procedure_annotations_storage.EmptyArena();
 		for (auto iter : this->inlinable_adjust_groups) {
-			iter.second->~vector<DeterministicSpriteGroupAdjust>();
+			std::destroy_at(iter.second);
 		}
 		this->inlinable_adjust_groups.clear();
 		this->inlinable_adjust_groups_storage.EmptyArena();
@@ -285,7 +287,38 @@ struct VarAction2AdjustInfo {
 
 const SpriteGroup *PruneTargetSpriteGroup(const SpriteGroup *result);
 void OptimiseVarAction2Adjust(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, DeterministicSpriteGroupAdjust &adjust);
-void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, std::vector<DeterministicSpriteGroupAdjust> &saved_adjusts);
+void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, SpriteGroupVector<DeterministicSpriteGroupAdjust> &saved_adjusts);
 void HandleVarAction2OptimisationPasses();
 
+/** Position and size of a sprite record, as found when reading ahead. */
+struct NewGRFReadAheadSprite {
+	size_t start_pos;     ///< File position of the start of the record.
+	size_t end_pos;       ///< File position of the end of the record.
+	uint32_t num;         ///< Size of the record data.
+	uint32_t data_offset; ///< Offset of the content in NewGRFReadAheadFile::data, for pseudo sprites.
+	byte type;            ///< Type of the record.
+};
+
+/** The sprite records of a NewGRF, read on a worker thread before the loading stages start. */
+struct NewGRFReadAheadFile {
+	std::string filename;                       ///< Name of the file.
+	Subdirectory subdir;                        ///< Sub directory of the file.
+	bool needs_palette_remap;                   ///< Whether the file needs a palette remap.
+	bool valid = false;                         ///< Whether the records were read successfully.
+	size_t start_pos = 0;                       ///< File position of the first record after the header.
+	size_t end_pos = 0;                         ///< File position of the end of sprites marker.
+	std::vector<NewGRFReadAheadSprite> sprites; ///< All records, in file order.
+	std::vector<byte> data;                     ///< The content of all pseudo sprites.
+	uint32_t read_time = 0;                     ///< Time taken to read the records, in microseconds.
+	std::string cache_filename;                 ///< Name of the file to cache the records in, empty if not cached.
+	MD5Hash md5sum;                             ///< MD5 checksum of the file, stored in the cache.
+	bool from_cache = false;                    ///< Whether the records were loaded from the cache.
+
+	void Read();
+	void ReadFile();
+	bool LoadCache(size_t file_size);
+	void SaveCache(size_t file_size) const;
+	bool Load(GrfLoadingStage stage, SpriteFile &file, ReusableBuffer<byte> &buf) const;
+};
+
 #endif /* NEWGRF_INTERNAL_H */
@@ -193,7 +193,7 @@ static bool IsIdenticalValueLoad(const DeterministicSpriteGroupAdjust *a, const
 			std::tie(b->type, b->variable, b->shift_num, b->parameter, b->and_mask, b->add_val, b->divmod_val);
 }
 
-static const DeterministicSpriteGroupAdjust *GetVarAction2PreviousSingleLoadAdjust(const std::vector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, bool *is_inverted)
+static const DeterministicSpriteGroupAdjust *GetVarAction2PreviousSingleLoadAdjust(const SpriteGroupVector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, bool *is_inverted)
 {
 	bool passed_store_perm = false;
 	if (is_inverted != nullptr) *is_inverted = false;
@@ -242,7 +242,7 @@ static const DeterministicSpriteGroupAdjust *GetVarAction2PreviousSingleLoadAdju
 	return nullptr;
 }
 
-static const DeterministicSpriteGroupAdjust *GetVarAction2PreviousSingleStoreAdjust(const std::vector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, bool *is_inverted)
+static const DeterministicSpriteGroupAdjust *GetVarAction2PreviousSingleStoreAdjust(const SpriteGroupVector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, bool *is_inverted)
 {
 	if (is_inverted != nullptr) *is_inverted = false;
 	for (int i = start_index; i >= 0; i--) {
@@ -433,7 +433,7 @@ static VarAction2AdjustsBooleanInverseResult AreVarAction2AdjustsBooleanInverse(
 	return VA2ABIR_NO;
 }
 
-static void GetBoolMulSourceAdjusts(std::vector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, uint store_var, DeterministicSpriteGroupAdjust &synth_adjust,
+static void GetBoolMulSourceAdjusts(SpriteGroupVector<DeterministicSpriteGroupAdjust> &adjusts, int start_index, uint store_var, DeterministicSpriteGroupAdjust &synth_adjust,
 	VarAction2AdjustDescriptor &found1, VarAction2AdjustDescriptor &found2, uint *mul_index)
 {
 	bool have_mul = false;
@@ -489,7 +489,7 @@ static void GetBoolMulSourceAdjusts(std::vector<DeterministicSpriteGroupAdjust>
  *   (-var * (var < 0)) + (var * !(var < 0)) with abs(var)
  * "+" may be ADD, OR or XOR.
  */
-static bool TryMergeBoolMulCombineVarAction2Adjust(VarAction2OptimiseState &state, std::vector<DeterministicSpriteGroupAdjust> &adjusts, const int adjust_index)
+static bool TryMergeBoolMulCombineVarAction2Adjust(VarAction2OptimiseState &state, SpriteGroupVector<DeterministicSpriteGroupAdjust> &adjusts, const int adjust_index)
 {
 	uint store_var = adjusts[adjust_index].parameter;
 
@@ -896,7 +896,7 @@ void OptimiseVarAction2Adjust(VarAction2OptimiseState &state, const VarAction2Ad
 		const DeterministicSpriteGroup *dsg = (const DeterministicSpriteGroup*)subroutine;
 		if (!(dsg->dsg_flags & DSGF_INLINE_CANDIDATE) || dsg->var_scope != group->var_scope || dsg->size != group->size) return false;
 
-		std::vector<DeterministicSpriteGroupAdjust> *proc = _cur.GetInlinableGroupAdjusts(dsg, false);
+		SpriteGroupVector<DeterministicSpriteGroupAdjust> *proc = _cur.GetInlinableGroupAdjusts(dsg, false);
 		if (proc == nullptr) return false;
 
 		byte shift_num = adjust.shift_num;
@@ -2574,7 +2574,7 @@ static bool IsVariableInlinable(uint16_t variable, GrfSpecFeature feature)
 	return false;
 }
 
-static void OptimiseVarAction2CheckInliningCandidate(DeterministicSpriteGroup *group, std::vector<DeterministicSpriteGroupAdjust> &saved_adjusts)
+static void OptimiseVarAction2CheckInliningCandidate(DeterministicSpriteGroup *group, SpriteGroupVector<DeterministicSpriteGroupAdjust> &saved_adjusts)
 {
 	if (HasGrfOptimiserFlag(NGOF_NO_OPT_VARACT2_PROC_INLINE)) return;
 	if (group->adjusts.size() > MAX_PROC_INLINE_ADJUST_COUNT || !group->calculated_result || group->var_scope != VSG_SCOPE_SELF) return;
@@ -2619,7 +2619,7 @@ static void PopulateRegistersUsedByNewGRFSpriteLayout(const NewGRFSpriteLayout &
 	}
 }
 
-void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, std::vector<DeterministicSpriteGroupAdjust> &saved_adjusts)
+void OptimiseVarAction2DeterministicSpriteGroup(VarAction2OptimiseState &state, const VarAction2AdjustInfo info, DeterministicSpriteGroup *group, SpriteGroupVector<DeterministicSpriteGroupAdjust> &saved_adjusts)
 {
 	if (unlikely(HasGrfOptimiserFlag(NGOF_NO_OPT_VARACT2))) return;
 
@@ -23,6 +23,18 @@
 
 #include "safeguards.h"
 
+/** An arena holding the data of the sprite groups of one or more NewGRFs, see #FreezeSpriteGroups. */
+struct SpriteGroupArena {
+	std::unique_ptr<byte[]> data; ///< The memory of the arena.
+	size_t size;                  ///< Size of #data.
+};
+
+/* Declared before the pool, as sprite groups in the pool may refer to arena memory until they are destroyed. */
+static std::map<const byte *, SpriteGroupArena> _sprite_group_arenas; ///< All arenas, by their start.
+static byte *_sprite_group_arena_pos = nullptr; ///< Next free byte of the arena being filled, or nullptr when no arena is being filled.
+static byte *_sprite_group_arena_end = nullptr; ///< End of the arena being filled.
+static size_t _sprite_group_freeze_index = 0;   ///< Sprite groups with a lower index were already handled by #FreezeSpriteGroups.
+
 SpriteGroupPool _spritegroup_pool("SpriteGroup");
 INSTANTIATE_POOL_METHODS(SpriteGroup)
 
@@ -32,6 +44,175 @@ std::map<const DeterministicSpriteGroup *, DeterministicSpriteGroupShadowCopy> _
 std::map<const RandomizedSpriteGroup *, RandomizedSpriteGroupShadowCopy> _randomized_sg_shadows;
 bool _grfs_loaded_with_sg_shadow_enable = false;
 
+/**
+ * Allocate memory for the data of a sprite group.
+ * While #FreezeSpriteGroups is filling an arena the memory is taken from that arena.
+ * @param size Number of bytes to allocate.
+ * @param align Required alignment.
+ * @return The memory.
+ */
+void *AllocateSpriteGroupData(size_t size, size_t align)
+{
+	if (_sprite_group_arena_pos != nullptr) {
+		byte *ptr = AlignPtr(_sprite_group_arena_pos, static_cast<uint>(align));
+		if (ptr <= _sprite_group_arena_end && size <= static_cast<size_t>(_sprite_group_arena_end - ptr)) {
+			_sprite_group_arena_pos = ptr + size;
+			return ptr;
+		}
+	}
+	return ::operator new(size);
+}
+
+/**
+ * Free memory of the data of a sprite group.
+ * Memory in an arena is only released with the arena itself.
+ * @param ptr The memory.
+ * @param size Number of bytes allocated.
+ * @param align Alignment of the allocation.
+ */
+void FreeSpriteGroupData(void *ptr, [[maybe_unused]] size_t size, [[maybe_unused]] size_t align)
+{
+	if (!_sprite_group_arenas.empty()) {
+		const byte *p = static_cast<const byte *>(ptr);
+		auto it = _sprite_group_arenas.upper_bound(p);
+		if (it != _sprite_group_arenas.begin()) {
+			--it;
+			if (p < it->first + it->second.size) return;
+		}
+	}
+	::operator delete(ptr);
+}
+
+/**
+ * Move the variable size data of all sprite groups created since the previous call into one new arena.
+ * The data is ordered as it is used while resolving: each group is directly followed by the groups it refers to,
+ * so resolving a chain of groups touches as few cache lines and pages as possible. This also drops any spare
+ * capacity of the vectors holding the data.
+ * Groups changed afterwards simply allocate their new data on the heap again.
+ * @return The sizes of the moved data.
+ */
+SpriteGroupFreezeStats FreezeSpriteGroups()
+{
+	SpriteGroupFreezeStats stats;
+
+	const size_t first = _sprite_group_freeze_index;
+	const size_t last = _spritegroup_pool.first_unused;
+	_sprite_group_freeze_index = last;
+	if (first >= last) return stats;
+
+	/* Order the groups depth first, from every group which was not reached from an earlier one. */
+	std::vector<SpriteGroup *> order;
+	std::vector<bool> seen(last - first);
+	std::vector<const SpriteGroup *> stack;
+	auto push = [&](const SpriteGroup *group) {
+		if (group != nullptr && group->index >= first && group->index < last && !seen[group->index - first]) stack.push_back(group);
+	};
+	for (SpriteGroup *root : SpriteGroup::Iterate(first)) {
+		if (root->index >= last) break;
+		push(root);
+		while (!stack.empty()) {
+			const SpriteGroup *group = stack.back();
+			stack.pop_back();
+			if (seen[group->index - first]) continue;
+			seen[group->index - first] = true;
+			order.push_back(SpriteGroup::Get(group->index));
+
+			/* Pushed in reverse, so that the first referred group is visited first. */
+			switch (group->type) {
+				case SGT_REAL: {
+					const RealSpriteGroup *rsg = static_cast<const RealSpriteGroup *>(group);
+					for (auto it = rsg->loading.rbegin(); it != rsg->loading.rend(); ++it) push(*it);
+					for (auto it = rsg->loaded.rbegin(); it != rsg->loaded.rend(); ++it) push(*it);
+					break;
+				}
+
+				case SGT_DETERMINISTIC: {
+					const DeterministicSpriteGroup *dsg = static_cast<const DeterministicSpriteGroup *>(group);
+					push(dsg->default_group);
+					for (auto it = dsg->ranges.rbegin(); it != dsg->ranges.rend(); ++it) push(it->group);
+					for (auto it = dsg->adjusts.rbegin(); it != dsg->adjusts.rend(); ++it) {
+						if (it->variable == 0x7E) push(it->subroutine);
+					}
+					break;
+				}
+
+				case SGT_RANDOMIZED: {
+					const RandomizedSpriteGroup *rsg = static_cast<const RandomizedSpriteGroup *>(group);
+					for (auto it = rsg->groups.rbegin(); it != rsg->groups.rend(); ++it) push(*it);
+					break;
+				}
+
+				default:
+					break;
+			}
+		}
+	}
+
+	/* Call a function for each vector with data, in arena order. */
+	auto for_each_vector = [&](auto handler) {
+		for (SpriteGroup *group : order) {
+			switch (group->type) {
+				case SGT_REAL: {
+					RealSpriteGroup *rsg = static_cast<RealSpriteGroup *>(group);
+					handler(rsg->loaded);
+					handler(rsg->loading);
+					break;
+				}
+
+				case SGT_DETERMINISTIC: {
+					DeterministicSpriteGroup *dsg = static_cast<DeterministicSpriteGroup *>(group);
+					handler(dsg->adjusts);
+					handler(dsg->ranges);
+					break;
+				}
+
+				case SGT_RANDOMIZED:
+					handler(static_cast<RandomizedSpriteGroup *>(group)->groups);
+					break;
+
+				default:
+					break;
+			}
+		}
+	};
+
+	size_t arena_size = 0;
+	for_each_vector([&](auto &vec) {
+		using T = typename std::remove_reference_t<decltype(vec)>::value_type;
+		stats.heap_bytes += vec.capacity() * sizeof(T);
+		if (!vec.empty()) arena_size = Align(arena_size, static_cast<uint>(alignof(T))) + vec.size() * sizeof(T);
+	});
+	stats.groups = order.size();
+	if (arena_size == 0) return stats;
+
+	SpriteGroupArena arena{ std::make_unique<byte[]>(arena_size), arena_size };
+	_sprite_group_arena_pos = arena.data.get();
+	_sprite_group_arena_end = arena.data.get() + arena_size;
+	for_each_vector([&](auto &vec) {
+		using V = std::remove_reference_t<decltype(vec)>;
+		V moved(vec.begin(), vec.end());
+		vec.swap(moved);
+	});
+	_sprite_group_arena_pos = nullptr;
+	_sprite_group_arena_end = nullptr;
+
+	stats.arena_bytes = arena_size;
+	const byte *start = arena.data.get();
+	_sprite_group_arenas.emplace(start, std::move(arena));
+	return stats;
+}
+
+/**
+ * Release all sprite group arenas.
+ * @pre The sprite group pool is empty.
+ */
+void ResetSpriteGroupArenas()
+{
+	assert(_spritegroup_pool.items == 0);
+	_sprite_group_arenas.clear();
+	_sprite_group_freeze_index = 0;
+}
+
 GrfSpecFeature GetGrfSpecFeatureForParentScope(GrfSpecFeature feature)
 {
 	switch (feature) {
@@ -666,8 +847,8 @@ void SpriteGroupDumper::DumpSpriteGroup(const SpriteGroup *sg, const char *paddi
 			const DeterministicSpriteGroup *dsg = (const DeterministicSpriteGroup*)sg;
 
 			const SpriteGroup *default_group = dsg->default_group;
-			const std::vector<DeterministicSpriteGroupAdjust> *adjusts = &(dsg->adjusts);
-			const std::vector<DeterministicSpriteGroupRange> *ranges = &(dsg->ranges);
+			const SpriteGroupVector<DeterministicSpriteGroupAdjust> *adjusts = &(dsg->adjusts);
+			const SpriteGroupVector<DeterministicSpriteGroupRange> *ranges = &(dsg->ranges);
 			bool calculated_result = dsg->calculated_result;
 
 			if (this->use_shadows) {
@@ -783,7 +964,7 @@ void SpriteGroupDumper::DumpSpriteGroup(const SpriteGroup *sg, const char *paddi
 		case SGT_RANDOMIZED: {
 			const RandomizedSpriteGroup *rsg = (const RandomizedSpriteGroup*)sg;
 
-			const std::vector<const SpriteGroup *> *groups = &(rsg->groups);
+			const SpriteGroupVector<const SpriteGroup *> *groups = &(rsg->groups);
 
 			if (this->use_shadows) {
 				auto iter = _randomized_sg_shadows.find(rsg);
@@ -59,6 +59,42 @@ struct AnalyseCallbackOperation;
 typedef Pool<SpriteGroup, SpriteGroupID, 1024, 1U << 30, PT_DATA> SpriteGroupPool;
 extern SpriteGroupPool _spritegroup_pool;
 
+void *AllocateSpriteGroupData(size_t size, size_t align);
+void FreeSpriteGroupData(void *ptr, size_t size, size_t align);
+
+/**
+ * Allocator for the variable size data of sprite groups.
+ * After loading a NewGRF the data of its sprite groups is moved into one contiguous arena, see #FreezeSpriteGroups.
+ * Memory in the arena is released with the arena itself, so freeing it here does nothing.
+ */
+template <typename T>
+struct SpriteGroupDataAllocator {
+	using value_type = T;
+
+	SpriteGroupDataAllocator() = default;
+	template <typename U> SpriteGroupDataAllocator(const SpriteGroupDataAllocator<U> &) {}
+
+	T *allocate(size_t n) { return static_cast<T *>(AllocateSpriteGroupData(n * sizeof(T), alignof(T))); }
+	void deallocate(T *ptr, size_t n) { FreeSpriteGroupData(ptr, n * sizeof(T), alignof(T)); }
+
+	template <typename U> bool operator==(const SpriteGroupDataAllocator<U> &) const { return true; }
+	template <typename U> bool operator!=(const SpriteGroupDataAllocator<U> &) const { return false; }
+};
+
+/** Vector holding variable size data of a sprite group. */
+template <typename T>
+using SpriteGroupVector = std::vector<T, SpriteGroupDataAllocator<T>>;
+
+/** Sizes of the sprite group data moved into an arena by #FreezeSpriteGroups. */
+struct SpriteGroupFreezeStats {
+	size_t groups = 0;       ///< Number of sprite groups with moved data.
+	size_t heap_bytes = 0;   ///< Bytes allocated for the data before moving it, excluding allocator overhead.
+	size_t arena_bytes = 0;  ///< Bytes of the arena the data was moved into.
+};
+
+SpriteGroupFreezeStats FreezeSpriteGroups();
+void ResetSpriteGroupArenas();
+
 enum SpriteGroupFlags : uint8_t {
 	SGF_NONE                     = 0,
 	SGF_ACTION6                  = 1 << 0,
@@ -103,8 +139,8 @@ struct RealSpriteGroup : SpriteGroup {
 	 * with small amount of cargo whilst loading is for stations with a lot
 	 * of da stuff. */
 
-	std::vector<const SpriteGroup *> loaded;  ///< List of loaded groups (can be SpriteIDs or Callback results)
-	std::vector<const SpriteGroup *> loading; ///< List of loading groups (can be SpriteIDs or Callback results)
+	SpriteGroupVector<const SpriteGroup *> loaded;  ///< List of loaded groups (can be SpriteIDs or Callback results)
+	SpriteGroupVector<const SpriteGroup *> loading; ///< List of loading groups (can be SpriteIDs or Callback results)
 
 	void AnalyseCallbacks(AnalyseCallbackOperation &op) const override;
 
@@ -484,8 +520,8 @@ enum DeterministicSpriteGroupFlags : uint8_t {
 DECLARE_ENUM_AS_BIT_SET(DeterministicSpriteGroupFlags)
 
 struct DeterministicSpriteGroupShadowCopy {
-	std::vector<DeterministicSpriteGroupAdjust> adjusts;
-	std::vector<DeterministicSpriteGroupRange> ranges;
+	SpriteGroupVector<DeterministicSpriteGroupAdjust> adjusts;
+	SpriteGroupVector<DeterministicSpriteGroupRange> ranges;
 	const SpriteGroup *default_group;
 	bool calculated_result;
 };
@@ -498,8 +534,8 @@ struct DeterministicSpriteGroup : SpriteGroup {
 	DeterministicSpriteGroupSize size;
 	bool calculated_result;
 	DeterministicSpriteGroupFlags dsg_flags = DSGF_NONE;
-	std::vector<DeterministicSpriteGroupAdjust> adjusts;
-	std::vector<DeterministicSpriteGroupRange> ranges; // Dynamically allocated
+	SpriteGroupVector<DeterministicSpriteGroupAdjust> adjusts;
+	SpriteGroupVector<DeterministicSpriteGroupRange> ranges; // Dynamically allocated
 
 	/* Dynamically allocated, this is the sole owner */
 	const SpriteGroup *default_group;
@@ -519,7 +555,7 @@ enum RandomizedSpriteGroupCompareMode : uint8_t {
 };
 
 struct RandomizedSpriteGroupShadowCopy {
-	std::vector<const SpriteGroup *> groups;
+	SpriteGroupVector<const SpriteGroup *> groups;
 };
 
 struct RandomizedSpriteGroup : SpriteGroup {
@@ -533,7 +569,7 @@ struct RandomizedSpriteGroup : SpriteGroup {
 
 	byte lowest_randbit; ///< Look for this in the per-object randomized bitmask:
 
-	std::vector<const SpriteGroup *> groups; ///< Take the group with appropriate index:
+	SpriteGroupVector<const SpriteGroup *> groups; ///< Take the group with appropriate index:
 
 	void AnalyseCallbacks(AnalyseCallbackOperation &op) const override;
 
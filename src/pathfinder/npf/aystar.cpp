@@ -308,11 +308,9 @@ void AyStar::AddStartNode(AyStarNode *start_node, uint g)
 void AyStar::Init(uint num_buckets)
 {
 	MemSetT(&neighbours, 0);
-	MemSetT(&openlist_queue, 0);
 
 	/* Set up our sorting queue
-	 *  BinaryHeap allocates a block of 1024 nodes
-	 *  When that one gets full it reserves another one, till this number
+	 *  BinaryHeap grows as required, till this number
 	 *  That is why it can stay this high */
 	this->openlist_queue.Init(102400);
 }
@@ -19,32 +19,15 @@
  * For information, see: http://www.policyalmanac.org/games/binaryHeaps.htm
  */
 
-const int BinaryHeap::BINARY_HEAP_BLOCKSIZE_BITS = 10; ///< The number of elements that will be malloc'd at a time.
-const int BinaryHeap::BINARY_HEAP_BLOCKSIZE      = 1 << BinaryHeap::BINARY_HEAP_BLOCKSIZE_BITS;
-const int BinaryHeap::BINARY_HEAP_BLOCKSIZE_MASK = BinaryHeap::BINARY_HEAP_BLOCKSIZE - 1;
-
 /**
  * Clears the queue, by removing all values from it. Its state is
  * effectively reset.
  */
 void BinaryHeap::Clear()
 {
-	/* Free all items if needed and free all but the first blocks of memory */
-	uint i;
-
-	for (i = 0; i < this->blocks; i++) {
-		if (this->elements[i] == nullptr) {
-			/* No more allocated blocks */
-			break;
-		}
-		if (i != 0) {
-			/* Leave the first block of memory alone */
-			free(this->elements[i]);
-			this->elements[i] = nullptr;
-		}
-	}
 	this->size = 0;
-	this->blocks = 1;
+	this->elements.resize(1);
+	this->positions.clear();
 }
 
 /**
@@ -53,14 +36,9 @@ void BinaryHeap::Clear()
  */
 void BinaryHeap::Free()
 {
-	uint i;
-
 	this->Clear();
-	for (i = 0; i < this->blocks; i++) {
-		if (this->elements[i] == nullptr) break;
-		free(this->elements[i]);
-	}
-	free(this->elements);
+	this->elements.shrink_to_fit();
+	this->positions.shrink_to_fit();
 }
 
 /**
@@ -72,31 +50,24 @@ bool BinaryHeap::Push(uint32_t item, int priority)
 	if (this->size == this->max_size) return false;
 	dbg_assert(this->size < this->max_size);
 
-	if (this->elements[this->size >> BINARY_HEAP_BLOCKSIZE_BITS] == nullptr) {
-		/* The currently allocated blocks are full, allocate a new one */
-		dbg_assert((this->size & BINARY_HEAP_BLOCKSIZE_MASK) == 0);
-		this->elements[this->size >> BINARY_HEAP_BLOCKSIZE_BITS] = MallocT<BinaryHeapNode>(BINARY_HEAP_BLOCKSIZE);
-		this->blocks++;
-	}
+	if (item >= this->positions.size()) this->positions.resize(item + 1, 0);
+	dbg_assert(this->positions[item] == 0);
 
 	/* Add the item at the end of the array */
-	BinaryHeapNode &new_item = this->GetElement(this->size + 1);
-	new_item.priority = priority;
-	new_item.item = item;
 	this->size++;
+	this->elements.push_back({ item, priority });
+	this->positions[item] = this->size;
 
 	/* Now we are going to check where it belongs. As long as the parent is
 	 * bigger, we switch with the parent */
 	{
-		int i = this->size;
+		uint i = this->size;
 		while (i > 1) {
 			/* Get the parent of this object (divide by 2) */
-			int j = i / 2;
+			uint j = i / 2;
 			/* Is the parent bigger than the current, switch them */
-			BinaryHeapNode &elem_i = this->GetElement(i);
-			BinaryHeapNode &elem_j = this->GetElement(j);
-			if (elem_i.priority <= elem_j.priority) {
-				std::swap(elem_i, elem_j);
+			if (this->GetElement(i).priority <= this->GetElement(j).priority) {
+				this->SwapElements(i, j);
 				i = j;
 			} else {
 				/* It is not, we're done! */
@@ -115,49 +86,43 @@ bool BinaryHeap::Push(uint32_t item, int priority)
  */
 bool BinaryHeap::Delete(uint32_t item, int priority)
 {
-	uint i = 0;
-
-	/* First, we try to find the item.. */
-	do {
-		if (this->GetElement(i + 1).item == item) break;
-		i++;
-	} while (i < this->size);
-	/* We did not find the item, so we return false */
-	if (i == this->size) return false;
+	/* First, we look up the item.. */
+	if (item >= this->positions.size() || this->positions[item] == 0) {
+		/* We did not find the item, so we return false */
+		return false;
+	}
+	uint i = this->positions[item];
+	this->positions[item] = 0;
 
 	/* Now we put the last item over the current item while decreasing the size of the elements */
+	BinaryHeapNode last = this->elements.back();
+	this->elements.pop_back();
 	this->size--;
-	this->GetElement(i + 1) = this->GetElement(this->size + 1);
+	if (i > this->size) return true;
+	this->SetElement(i, last);
 
 	/* Now the only thing we have to do, is resort it..
 	 * On place i there is the item to be sorted.. let's start there */
-	{
-		/* Because of the fact that Binary Heap uses array from 1 to n, we need to
-		 * increase i by 1
-		 */
-		i++;
-
-		for (;;) {
-			uint j = i;
-			/* Check if we have 2 children */
-			if (2 * j + 1 <= this->size) {
-				/* Is this child smaller than the parent? */
-				if (this->GetElement(j).priority >= this->GetElement(2 * j).priority) i = 2 * j;
-				/* Yes, we _need_ to use i here, not j, because we want to have the smallest child
-				 *  This way we get that straight away! */
-				if (this->GetElement(i).priority >= this->GetElement(2 * j + 1).priority) i = 2 * j + 1;
-			/* Do we have one child? */
-			} else if (2 * j <= this->size) {
-				if (this->GetElement(j).priority >= this->GetElement(2 * j).priority) i = 2 * j;
-			}
+	for (;;) {
+		uint j = i;
+		/* Check if we have 2 children */
+		if (2 * j + 1 <= this->size) {
+			/* Is this child smaller than the parent? */
+			if (this->GetElement(j).priority >= this->GetElement(2 * j).priority) i = 2 * j;
+			/* Yes, we _need_ to use i here, not j, because we want to have the smallest child
+			 *  This way we get that straight away! */
+			if (this->GetElement(i).priority >= this->GetElement(2 * j + 1).priority) i = 2 * j + 1;
+		/* Do we have one child? */
+		} else if (2 * j <= this->size) {
+			if (this->GetElement(j).priority >= this->GetElement(2 * j).priority) i = 2 * j;
+		}
 
-			/* One of our children is smaller than we are, switch */
-			if (i != j) {
-				std::swap(this->GetElement(i), this->GetElement(j));
-			} else {
-				/* None of our children is smaller, so we stay here.. stop :) */
-				break;
-			}
+		/* One of our children is smaller than we are, switch */
+		if (i != j) {
+			this->SwapElements(i, j);
+		} else {
+			/* None of our children is smaller, so we stay here.. stop :) */
+			break;
 		}
 	}
 
@@ -181,23 +146,17 @@ uint32_t BinaryHeap::Pop()
 }
 
 /**
- * Initializes a binary heap and allocates internal memory for maximum of
- * max_size elements
+ * Initializes a binary heap for a maximum of max_size elements
  */
 void BinaryHeap::Init(uint max_size)
 {
 	this->max_size = max_size;
 	this->size = 0;
-	/* We malloc memory in block of BINARY_HEAP_BLOCKSIZE
-	 *   It autosizes when it runs out of memory */
-	this->elements = CallocT<BinaryHeapNode*>((max_size - 1) / BINARY_HEAP_BLOCKSIZE + 1);
-	this->elements[0] = MallocT<BinaryHeapNode>(BINARY_HEAP_BLOCKSIZE);
-	this->blocks = 1;
+	/* Element 0 is unused, so that the heap can be indexed from 1 */
+	this->elements.resize(1);
+	this->positions.clear();
 }
 
-/* Because we don't want anyone else to bother with our defines */
-#undef BIN_HEAP_ARR
-
 /*
  * Hash
  */
@@ -13,6 +13,8 @@
 #include "../../tile_type.h"
 #include "../../track_type.h"
 
+#include <vector>
+
 //#define HASH_STATS
 
 
@@ -25,12 +27,12 @@ struct BinaryHeapNode {
 /**
  * Binary Heap.
  * For information, see: http://www.policyalmanac.org/games/binaryHeaps.htm
+ *
+ * The position of each item in the heap is tracked, so that deleting an
+ * arbitrary item does not require a linear search of the heap.
+ * Items should therefore be small integers, such as pool indices.
  */
 struct BinaryHeap {
-	static const int BINARY_HEAP_BLOCKSIZE;
-	static const int BINARY_HEAP_BLOCKSIZE_BITS;
-	static const int BINARY_HEAP_BLOCKSIZE_MASK;
-
 	void Init(uint max_size);
 
 	bool Push(uint32_t item, int priority);
@@ -47,13 +49,27 @@ struct BinaryHeap {
 	inline BinaryHeapNode &GetElement(uint i)
 	{
 		dbg_assert(i > 0);
-		return this->elements[(i - 1) >> BINARY_HEAP_BLOCKSIZE_BITS][(i - 1) & BINARY_HEAP_BLOCKSIZE_MASK];
+		return this->elements[i];
 	}
 
 	uint max_size;
 	uint size;
-	uint blocks; ///< The amount of blocks for which space is reserved in elements
-	BinaryHeapNode **elements;
+	std::vector<BinaryHeapNode> elements; ///< Heap elements, starting at offset 1.
+	std::vector<uint32_t> positions;      ///< Position in #elements of each item, or 0 if the item is not in the heap.
+
+private:
+	inline void SetElement(uint i, const BinaryHeapNode &node)
+	{
+		this->elements[i] = node;
+		this->positions[node.item] = i;
+	}
+
+	inline void SwapElements(uint i, uint j)
+	{
+		std::swap(this->elements[i], this->elements[j]);
+		this->positions[this->elements[i].item] = i;
+		this->positions[this->elements[j].item] = j;
+	}
 };
 
 
@@ -14,6 +14,14 @@
 #include "fileio_func.h"
 #include "string_func.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include "safeguards.h"
 
 /**
@@ -44,9 +52,78 @@ RandomAccessFile::RandomAccessFile(const std::string &filename, Subdirectory sub
  */
 RandomAccessFile::~RandomAccessFile()
 {
+	this->UnmapFile();
 	fclose(this->file_handle);
 }
 
+/**
+ * Try to map the whole file into memory, so reading from it does not need any system calls or copies to the buffer.
+ * The file is read through the buffer when mapping is not possible.
+ * This is only done when there is plenty of address space, i.e. for 64 bits builds.
+ * The file must not shrink while it is mapped, so only map it for a bounded time, e.g. while loading NewGRFs.
+ * The position in the file is kept.
+ */
+void RandomAccessFile::MapFile()
+{
+	if (this->mapping != nullptr) return;
+#if defined(POINTER_IS_64BIT) && !defined(__EMSCRIPTEN__)
+#	if defined(_WIN32)
+	HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(this->file_handle)));
+	LARGE_INTEGER size;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart <= 0) return;
+
+	HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		DEBUG(misc, 3, "Mapping %s into memory failed, reading it instead", this->filename.c_str());
+		return;
+	}
+	/* The view keeps the mapping alive. */
+	const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == nullptr) {
+		DEBUG(misc, 3, "Mapping %s into memory failed, reading it instead", this->filename.c_str());
+		return;
+	}
+	size_t pos = this->GetPos();
+	this->mapping = static_cast<const byte *>(view);
+	this->mapping_size = static_cast<size_t>(size.QuadPart);
+	this->SeekTo(pos, SEEK_SET);
+#	else
+	int fd = fileno(this->file_handle);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return;
+
+	void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	if (view == MAP_FAILED) {
+		DEBUG(misc, 3, "Mapping %s into memory failed, reading it instead", this->filename.c_str());
+		return;
+	}
+	size_t pos = this->GetPos();
+	this->mapping = static_cast<const byte *>(view);
+	this->mapping_size = static_cast<size_t>(st.st_size);
+	this->SeekTo(pos, SEEK_SET);
+#	endif
+#endif
+}
+
+/**
+ * Release the mapping of the file, if any, and continue reading it through the buffer.
+ * The position in the file is kept.
+ */
+void RandomAccessFile::UnmapFile()
+{
+	if (this->mapping == nullptr) return;
+	size_t pos = this->GetPos();
+#if defined(_WIN32)
+	UnmapViewOfFile(this->mapping);
+#else
+	munmap(const_cast<byte *>(this->mapping), this->mapping_size);
+#endif
+	this->mapping = nullptr;
+	this->mapping_size = 0;
+	this->SeekTo(pos, SEEK_SET);
+}
+
 /**
  * Get the filename of the opened file with the path from the SubDirectory and the extension.
  * @return Name of the file.
@@ -84,6 +161,14 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += this->GetPos();
 
+	if (this->mapping != nullptr) {
+		/* The whole mapping is the buffer; the position of its end is the size of the file. */
+		this->buffer = this->mapping + std::min(pos, this->mapping_size);
+		this->buffer_end = this->mapping + this->mapping_size;
+		this->pos = this->mapping_size;
+		return;
+	}
+
 	this->pos = pos;
 	if (fseek(this->file_handle, this->pos, SEEK_SET) < 0) {
 		DEBUG(misc, 0, "Seeking in %s failed", this->filename.c_str());
@@ -100,8 +185,11 @@ void RandomAccessFile::SeekTo(size_t pos, int mode)
 byte RandomAccessFile::ReadByteIntl()
 {
 	if (this->buffer == this->buffer_end) {
+		/* The end of a mapped file is the end of the buffer. */
+		if (this->mapping != nullptr) return 0;
+
 		this->buffer = this->buffer_start;
-		size_t size = fread(this->buffer, 1, RandomAccessFile::BUFFER_SIZE, this->file_handle);
+		size_t size = fread(this->buffer_start, 1, RandomAccessFile::BUFFER_SIZE, this->file_handle);
 		this->pos += size;
 		this->buffer_end = this->buffer_start + size;
 
@@ -137,6 +225,13 @@ uint32_t RandomAccessFile::ReadDwordIntl()
  */
 void RandomAccessFile::ReadBlock(void *ptr, size_t size)
 {
+	if (this->mapping != nullptr) {
+		size = std::min<size_t>(size, this->buffer_end - this->buffer);
+		memcpy(ptr, this->buffer, size);
+		this->buffer += size;
+		return;
+	}
+
 	this->SeekTo(this->GetPos(), SEEK_SET);
 	this->pos += fread(ptr, 1, size, this->file_handle);
 }
@@ -31,10 +31,13 @@ class RandomAccessFile {
 	FILE *file_handle;               ///< File handle of the open file.
 	size_t pos;                      ///< Position in the file of the end of the read buffer.
 
-	byte *buffer;                    ///< Current position within the local buffer.
-	byte *buffer_end;                ///< Last valid byte of buffer.
+	const byte *buffer;              ///< Current position within the local buffer, or within the mapping.
+	const byte *buffer_end;          ///< Last valid byte of buffer.
 	byte buffer_start[BUFFER_SIZE];  ///< Local buffer when read from file.
 
+	const byte *mapping = nullptr;   ///< The whole file mapped into memory, or nullptr when the file is read through #file_handle.
+	size_t mapping_size = 0;         ///< Size of #mapping.
+
 	byte ReadByteIntl();
 	uint16_t ReadWordIntl();
 	uint32_t ReadDwordIntl();
@@ -52,6 +55,9 @@ public:
 	size_t GetPos() const;
 	void SeekTo(size_t pos, int mode);
 
+	void MapFile();
+	void UnmapFile();
+
 	inline byte ReadByte()
 	{
 		if (likely(this->buffer != this->buffer_end)) return *this->buffer++;
@@ -88,6 +94,26 @@ public:
 
 	void ReadBlock(void *ptr, size_t size);
 	void SkipBytes(size_t n);
+
+	/**
+	 * Whether the file is mapped into memory, instead of being read through a buffer.
+	 * @return True when the file is mapped.
+	 */
+	bool IsMapped() const { return this->mapping != nullptr; }
+
+	/**
+	 * Read a block directly from the mapped file, without copying it.
+	 * @param size Number of bytes to read.
+	 * @return Pointer to the bytes, valid as long as the file is mapped, or nullptr when the file is not mapped or
+	 *         fewer bytes remain in the file; the position in the file is unchanged in that case.
+	 */
+	inline const byte *ReadBlockView(size_t size)
+	{
+		if (this->mapping == nullptr || size > static_cast<size_t>(this->buffer_end - this->buffer)) return nullptr;
+		const byte *data = this->buffer;
+		this->buffer += size;
+		return data;
+	}
 };
 
 #endif /* RANDOM_ACCESS_FILE_TYPE_H */
@@ -50,7 +50,7 @@ struct FlowSaveLoad {
 	bool restricted;
 };
 
-typedef std::pair<const StationID, CargoPacketList > StationCargoPair;
+typedef StationCargoPacketMap::value_type StationCargoPair;
 
 static OldPersistentStorage _old_st_persistent_storage;
 static byte _old_last_vehicle_type;
@@ -65,7 +65,7 @@ static void SwapPackets(GoodsEntry *ge)
 	StationCargoPacketMap &ge_packets = const_cast<StationCargoPacketMap &>(*ge->data->cargo.Packets());
 
 	if (_packets.empty()) {
-		std::map<StationID, CargoPacketList>::iterator it(ge_packets.find(INVALID_STATION));
+		StationCargoPacketMap::MapIterator it(ge_packets.find(INVALID_STATION));
 		if (it == ge_packets.end()) {
 			return;
 		} else {
@@ -0,0 +1,251 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file scan_index.cpp Persistent index of the MD5 checksums of scanned content files.
+ *
+ * Scanning the NewGRF directories and checking scripts against the content service needs the MD5 checksum
+ * of each file, which requires reading the complete file. The index remembers the checksum of each file
+ * together with its size and modification time, so that only new or modified files need to be read again.
+ */
+
+#include "stdafx.h"
+#include "scan_index.h"
+#include "debug.h"
+#include "fileio_func.h"
+#include "settings_type.h"
+#include "core/serialisation.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "safeguards.h"
+
+/** Identifier at the start of the scan index file. */
+static const uint32_t SCAN_INDEX_MAGIC = 0x58444E49; // 'INDX'
+/** Version of the format of the scan index file. */
+static const uint32_t SCAN_INDEX_VERSION = 2;
+
+/**
+ * Files modified less than this many nanoseconds before they are scanned are not indexed.
+ * On file systems with coarse timestamps such a file could still be changed without changing its modification time.
+ */
+static const int64_t SCAN_INDEX_RECENT_CHANGE_TIME = 3'000'000'000LL;
+
+/** An entry of the scan index. */
+struct ScanIndexEntry {
+	uint64_t size;   ///< Number of bytes checksummed.
+	int64_t mtime;   ///< Modification time of the file, in nanoseconds since 1970.
+	MD5Hash md5sum;  ///< The checksum.
+	bool used;       ///< Whether the entry was looked up or updated since the game started.
+};
+
+static std::mutex _scan_index_lock;                                  ///< Lock for the index, checksums are calculated on several threads.
+static std::unordered_map<std::string, ScanIndexEntry> _scan_index; ///< The index, by path.
+static bool _scan_index_loaded = false;                              ///< Whether the index file has been read.
+static bool _scan_index_dirty = false;                               ///< Whether the index has changed since it was read or written.
+
+/**
+ * Get the name of the scan index file.
+ * @return The name, or an empty string if there is no personal directory.
+ */
+static std::string GetScanIndexFilename()
+{
+	if (_personal_dir.empty()) return {};
+	return _personal_dir + "cache" PATHSEP "scan_index.dat";
+}
+
+/** Read the index file, if that has not been done yet. The lock must be held. */
+static void LoadScanIndexIfNeeded()
+{
+	if (_scan_index_loaded) return;
+	_scan_index_loaded = true;
+
+	std::string filename = GetScanIndexFilename();
+	if (filename.empty()) return;
+
+	std::vector<byte> buffer;
+	{
+		std::unique_ptr<FILE, FileDeleter> fp(fopen(filename.c_str(), "rb"));
+		if (fp == nullptr) return;
+		if (fseek(fp.get(), 0, SEEK_END) != 0) return;
+		long size = ftell(fp.get());
+		if (size <= 0 || fseek(fp.get(), 0, SEEK_SET) != 0) return;
+		buffer.resize(size);
+		if (fread(buffer.data(), 1, buffer.size(), fp.get()) != buffer.size()) return;
+	}
+
+	BufferDeserialiser reader(buffer);
+	if (reader.Recv_uint32() != SCAN_INDEX_MAGIC || reader.Recv_uint32() != SCAN_INDEX_VERSION) return;
+	uint32_t count = reader.Recv_uint32();
+	for (uint32_t i = 0; i < count && !reader.error; i++) {
+		std::string path;
+		reader.Recv_string(path, SVS_NONE);
+		ScanIndexEntry entry;
+		entry.size = reader.Recv_uint64();
+		entry.mtime = static_cast<int64_t>(reader.Recv_uint64());
+		std::span<const uint8_t> md5sum = reader.Recv_binary_view(entry.md5sum.size());
+		if (reader.error) break;
+		std::copy(md5sum.begin(), md5sum.end(), entry.md5sum.begin());
+		entry.used = false;
+		_scan_index[std::move(path)] = entry;
+	}
+	if (reader.error) _scan_index.clear();
+}
+
+/**
+ * Get the modification time of an opened file.
+ * @param f The file.
+ * @param[out] mtime The modification time, in nanoseconds since 1970.
+ * @return True if the modification time could be determined.
+ */
+static bool GetFileModificationTime(FILE *f, int64_t &mtime)
+{
+#if defined(_WIN32)
+	HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f)));
+	FILETIME ft;
+	if (GetFileTime(handle, nullptr, nullptr, &ft) == 0) return false;
+
+	/* Convert from hectonanoseconds since 01/01/1601 to nanoseconds since 01/01/1970 */
+	ULARGE_INTEGER ft_int64;
+	ft_int64.HighPart = ft.dwHighDateTime;
+	ft_int64.LowPart = ft.dwLowDateTime;
+	mtime = (static_cast<int64_t>(ft_int64.QuadPart) - 116444736000000000LL) * 100;
+#else
+	struct stat sb;
+	if (fstat(fileno(f), &sb) != 0) return false;
+#	if defined(__APPLE__)
+	mtime = static_cast<int64_t>(sb.st_mtimespec.tv_sec) * 1000000000 + sb.st_mtimespec.tv_nsec;
+#	elif defined(__OS2__)
+	mtime = static_cast<int64_t>(sb.st_mtime) * 1000000000;
+#	else
+	mtime = static_cast<int64_t>(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+#	endif
+#endif
+	return true;
+}
+
+/**
+ * Get the key of an opened file.
+ * @param f The opened file, for files in a tar the tar file.
+ * @param path Full path of the file, as returned by FioFOpenFile.
+ * @param size Number of bytes which are checksummed.
+ * @param[out] key The key.
+ * @return True if the key could be determined, the index should not be used otherwise.
+ */
+bool GetScanIndexKey(FILE *f, const std::string &path, size_t size, ScanIndexKey &key)
+{
+	if (!_settings_client.gui.scan_index || path.empty()) return false;
+
+	if (!GetFileModificationTime(f, key.mtime)) return false;
+
+	/* A file which was just changed might be changed again within the resolution of its modification time. */
+	int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	if (key.mtime > now - SCAN_INDEX_RECENT_CHANGE_TIME) return false;
+
+	key.path = path;
+	key.size = size;
+	return true;
+}
+
+/**
+ * Look up the checksum of a file in the index.
+ * @param key The key of the file.
+ * @param[out] md5sum The checksum, if found.
+ * @return True if the file is in the index, and has not been changed since.
+ */
+bool LookupScanIndex(const ScanIndexKey &key, MD5Hash &md5sum)
+{
+	std::lock_guard<std::mutex> guard(_scan_index_lock);
+	LoadScanIndexIfNeeded();
+
+	auto it = _scan_index.find(key.path);
+	if (it == _scan_index.end() || it->second.size != key.size || it->second.mtime != key.mtime) return false;
+
+	it->second.used = true;
+	md5sum = it->second.md5sum;
+	return true;
+}
+
+/**
+ * Store the checksum of a file in the index.
+ * @param key The key of the file.
+ * @param md5sum The checksum.
+ */
+void UpdateScanIndex(const ScanIndexKey &key, const MD5Hash &md5sum)
+{
+	std::lock_guard<std::mutex> guard(_scan_index_lock);
+	LoadScanIndexIfNeeded();
+
+	_scan_index[key.path] = { key.size, key.mtime, md5sum, true };
+	_scan_index_dirty = true;
+}
+
+/**
+ * Check whether the file of an index entry still exists.
+ * @param path The path of the entry.
+ * @return True if the file, or the tar containing it, exists.
+ */
+static bool ScanIndexFileExists(const std::string &path)
+{
+	/* Files in tars do not exist on their own; the first part of the path which exists is the tar then. */
+	for (size_t end = path.size(); end != std::string::npos && end > 0; end = path.rfind(PATHSEPCHAR, end - 1)) {
+#if defined(_WIN32)
+		DWORD attributes = GetFileAttributes(OTTD2FS(path.substr(0, end)).c_str());
+		if (attributes != INVALID_FILE_ATTRIBUTES) return (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0;
+#else
+		struct stat sb;
+		if (stat(path.substr(0, end).c_str(), &sb) == 0) return S_ISREG(sb.st_mode);
+#endif
+	}
+	return false;
+}
+
+/**
+ * Write the index file, if the index has changed.
+ * Entries of files which have not been seen since the game started are only kept if the file still exists.
+ */
+void SaveScanIndex()
+{
+	std::lock_guard<std::mutex> guard(_scan_index_lock);
+	if (!_scan_index_dirty) return;
+	_scan_index_dirty = false;
+
+	std::string filename = GetScanIndexFilename();
+	if (filename.empty()) return;
+	FioCreateDirectory(_personal_dir + "cache" PATHSEP);
+
+	std::vector<byte> buffer;
+	BufferSerialiser writer(buffer);
+	writer.Send_uint32(SCAN_INDEX_MAGIC);
+	writer.Send_uint32(SCAN_INDEX_VERSION);
+	size_t count_pos = buffer.size();
+	writer.Send_uint32(0);
+
+	uint32_t count = 0;
+	for (const auto &it : _scan_index) {
+		if (!it.second.used && !ScanIndexFileExists(it.first)) continue;
+
+		writer.Send_string(it.first);
+		writer.Send_uint64(it.second.size);
+		writer.Send_uint64(static_cast<uint64_t>(it.second.mtime));
+		writer.Send_binary(it.second.md5sum.data(), it.second.md5sum.size());
+		count++;
+	}
+	for (uint i = 0; i < 4; i++) buffer[count_pos + i] = GB(count, i * 8, 8);
+
+	if (!FioReplaceFile(filename, buffer.data(), buffer.size())) {
+		DEBUG(misc, 1, "Could not write scan index file %s", filename.c_str());
+	}
+}
@@ -0,0 +1,28 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file scan_index.h Persistent index of the MD5 checksums of scanned content files. */
+
+#ifndef SCAN_INDEX_H
+#define SCAN_INDEX_H
+
+#include "3rdparty/md5/md5.h"
+#include <string>
+
+/** Key of a file in the scan index. */
+struct ScanIndexKey {
+	std::string path; ///< Full path of the file, for files in a tar the path of the tar followed by the name in the tar.
+	uint64_t size;    ///< Number of bytes checksummed.
+	int64_t mtime;    ///< Modification time of the file, or of the tar, in nanoseconds since 1970.
+};
+
+bool GetScanIndexKey(FILE *f, const std::string &path, size_t size, ScanIndexKey &key);
+bool LookupScanIndex(const ScanIndexKey &key, MD5Hash &md5sum);
+void UpdateScanIndex(const ScanIndexKey &key, const MD5Hash &md5sum);
+void SaveScanIndex();
+
+#endif /* SCAN_INDEX_H */
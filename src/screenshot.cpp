@@ -32,6 +32,11 @@
 #include "smallmap_colours.h"
 #include "smallmap_gui.h"
 #include "screenshot_gui.h"
+#include "worker_thread.h"
+#include "string_func.h"
+#include "core/math_func.hpp"
+
+#include <atomic>
 
 #include "table/strings.h"
 
@@ -50,6 +55,12 @@ uint _heightmap_highest_peak;         ///< When saving a heightmap, this contain
 static const char *_screenshot_aux_text_key = nullptr;
 static const char *_screenshot_aux_text_value = nullptr;
 
+/**
+ * Whether the screenshot being made may be written by a separate thread while the next lines are rendered.
+ * This is only set for screenshots which render the lines on demand, and never for crash log screenshots.
+ */
+static bool _screenshot_threaded_encode = false;
+
 void SetScreenshotAuxiliaryText(const char *key, const char *value)
 {
 	_screenshot_aux_text_key = key;
@@ -250,6 +261,12 @@ static bool MakeBMPImage(const char *name, ScreenshotCallback *callb, void *user
 #include "base_media_base.h"
 #endif /* PNG_TEXT_SUPPORTED */
 
+#include "thread.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 static void PNGAPI png_my_error(png_structp png_ptr, png_const_charp message)
 {
 	DEBUG(misc, 0, "[libpng] error: %s - %s", message, (const char *)png_get_error_ptr(png_ptr));
@@ -261,6 +278,110 @@ static void PNGAPI png_my_warning(png_structp png_ptr, png_const_charp message)
 	DEBUG(misc, 1, "[libpng] warning: %s - %s", message, (const char *)png_get_error_ptr(png_ptr));
 }
 
+static const uint PNG_THREADED_BUFFER_SIZE = 64 << 20; ///< Target size in bytes of each of the two line buffers of #PNGThreadedWriter.
+
+/**
+ * Writer for .PNG files which compresses and writes lines on a separate thread while the next lines are rendered.
+ * Two buffers of lines are used alternately, so the memory use is bounded regardless of the size of the image.
+ */
+class PNGThreadedWriter {
+	png_structp png_ptr;
+	png_infop info_ptr;
+	size_t line_size;                  ///< Size of one line in bytes.
+	uint maxlines;                     ///< Number of lines in each buffer.
+	std::unique_ptr<uint8_t[]> buffers[2];
+	uint lines[2] = { 0, 0 };          ///< Number of rendered lines in each buffer waiting to be written, 0 if the buffer is free.
+	bool finished = false;             ///< All lines have been rendered.
+	bool failed = false;               ///< Writing failed.
+	std::mutex lock;
+	std::condition_variable cv;
+	std::thread thread;
+
+	/**
+	 * Write the lines of the buffers as they become ready, this runs on the writer thread.
+	 * libpng reports errors with longjmp, so the jump buffer is set up on this thread.
+	 */
+	static void WriteThread(PNGThreadedWriter *self)
+	{
+		if (setjmp(png_jmpbuf(self->png_ptr))) {
+			std::lock_guard<std::mutex> lk(self->lock);
+			self->failed = true;
+			self->cv.notify_all();
+			return;
+		}
+
+		for (uint slot = 0;; slot ^= 1) {
+			uint n;
+			{
+				std::unique_lock<std::mutex> lk(self->lock);
+				self->cv.wait(lk, [&]() { return self->lines[slot] != 0 || self->finished; });
+				n = self->lines[slot];
+			}
+			if (n == 0) break;
+
+			for (uint i = 0; i != n; i++) {
+				png_write_row(self->png_ptr, self->buffers[slot].get() + i * self->line_size);
+			}
+
+			std::lock_guard<std::mutex> lk(self->lock);
+			self->lines[slot] = 0;
+			self->cv.notify_all();
+		}
+
+		png_write_end(self->png_ptr, self->info_ptr);
+	}
+
+public:
+	PNGThreadedWriter(png_structp png_ptr, png_infop info_ptr, size_t line_size, uint maxlines)
+			: png_ptr(png_ptr), info_ptr(info_ptr), line_size(line_size), maxlines(maxlines) {}
+
+	/**
+	 * Start the writer thread.
+	 * @return true if the thread was started.
+	 */
+	bool Start()
+	{
+		for (auto &buffer : this->buffers) buffer.reset(new uint8_t[this->line_size * this->maxlines]);
+		return StartNewThread(&this->thread, "ottd:screenshot", &PNGThreadedWriter::WriteThread, this);
+	}
+
+	/**
+	 * Render all lines of the image on this thread, and hand them over to the writer thread.
+	 * @param callb Callback to render lines.
+	 * @param userdata Data for the callback.
+	 * @param w Width of the image in pixels.
+	 * @param h Height of the image in pixels.
+	 * @return true if the image was written successfully.
+	 */
+	bool Run(ScreenshotCallback *callb, void *userdata, uint w, uint h)
+	{
+		uint slot = 0;
+		for (uint y = 0; y != h; slot ^= 1) {
+			{
+				std::unique_lock<std::mutex> lk(this->lock);
+				this->cv.wait(lk, [&]() { return this->lines[slot] == 0 || this->failed; });
+				if (this->failed) break;
+			}
+
+			uint n = std::min(h - y, this->maxlines);
+			callb(userdata, this->buffers[slot].get(), y, w, n);
+			y += n;
+
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->lines[slot] = n;
+			this->cv.notify_all();
+		}
+
+		{
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->finished = true;
+			this->cv.notify_all();
+		}
+		this->thread.join();
+		return !this->failed;
+	}
+};
+
 /**
  * Generic .PNG file image writer.
  * @param name        Filename, including extension.
@@ -395,6 +516,20 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 #endif /* TTD_ENDIAN == TTD_LITTLE_ENDIAN */
 	}
 
+	if (_screenshot_threaded_encode) {
+		/* Use larger blocks of lines, this reduces how often sprites overlapping several blocks have to be drawn again. */
+		maxlines = Clamp(PNG_THREADED_BUFFER_SIZE / (w * bpp), 16, 512);
+		if (h > maxlines) {
+			PNGThreadedWriter writer(png_ptr, info_ptr, w * bpp, maxlines);
+			if (writer.Start()) {
+				bool ok = writer.Run(callb, userdata, w, h);
+				png_destroy_write_struct(&png_ptr, &info_ptr);
+				fclose(f);
+				return ok;
+			}
+		}
+	}
+
 	/* use by default 64k temp memory */
 	maxlines = Clamp(65536 / w, 16, 128);
 
@@ -423,6 +558,62 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 	fclose(f);
 	return true;
 }
+
+/**
+ * Write an 8bpp image to a .PNG file, without any game metadata.
+ * This may be called from several threads at once.
+ * @param name    File name including extension.
+ * @param pixels  Palette indices of the pixels, row by row.
+ * @param w       Width of the image in pixels.
+ * @param h       Height of the image in pixels.
+ * @param palette %Colour palette.
+ * @return File was written successfully.
+ */
+static bool WritePalettePNGFile(const char *name, const uint8_t *pixels, uint w, uint h, const Colour *palette)
+{
+	FILE *f = fopen(name, "wb");
+	if (f == nullptr) return false;
+
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, const_cast<char *>(name), png_my_error, png_my_warning);
+	if (png_ptr == nullptr) {
+		fclose(f);
+		return false;
+	}
+
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (info_ptr == nullptr) {
+		png_destroy_write_struct(&png_ptr, (png_infopp)nullptr);
+		fclose(f);
+		return false;
+	}
+
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		fclose(f);
+		return false;
+	}
+
+	png_init_io(png_ptr, f);
+	png_set_IHDR(png_ptr, info_ptr, w, h, 8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+	png_color rq[256];
+	for (uint i = 0; i != 256; i++) {
+		rq[i].red   = palette[i].r;
+		rq[i].green = palette[i].g;
+		rq[i].blue  = palette[i].b;
+	}
+	png_set_PLTE(png_ptr, info_ptr, rq, 256);
+
+	png_write_info(png_ptr, info_ptr);
+	for (uint y = 0; y != h; y++) {
+		png_write_row(png_ptr, const_cast<png_bytep>(pixels + y * w));
+	}
+	png_write_end(png_ptr, info_ptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+
+	fclose(f);
+	return true;
+}
 #endif /* WITH_PNG */
 
 
@@ -852,6 +1043,8 @@ static bool MakeLargeWorldScreenshot(ScreenshotType t, uint32_t width = 0, uint3
 	Viewport vp;
 	SetupScreenshotViewport(t, &vp, width, height);
 
+	AutoRestoreBackup threaded_backup(_screenshot_threaded_encode, true);
+
 	const ScreenshotFormat *sf = _screenshot_formats + _cur_screenshot_format;
 	return sf->proc(MakeScreenshotName(SCREENSHOT_NAME, sf->extension), LargeWorldCallback, &vp, vp.width, vp.height,
 			BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
@@ -1082,6 +1275,7 @@ static void SmallMapCallback(void *userdata, void *buf, uint y, uint pitch, uint
 bool MakeSmallMapScreenshot(unsigned int width, unsigned int height, SmallMapWindow *window)
 {
 	_screenshot_name[0] = '\0';
+	AutoRestoreBackup threaded_backup(_screenshot_threaded_encode, true);
 	const ScreenshotFormat *sf = _screenshot_formats + _cur_screenshot_format;
 	bool ret = sf->proc(MakeScreenshotName(SCREENSHOT_NAME, sf->extension), SmallMapCallback, window, width, height, BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
 	ShowScreenshotResultMessage(SC_SMALLMAP, ret);
@@ -1291,15 +1485,12 @@ void MinimapScreenCallback(void *userdata, void *buf, uint y, uint pitch, uint n
 }
 
 /**
- * Return the color value of a tile to display it with in the minimap screenshot.
- *
- * @param tile The tile of which we would like to get the colour.
- * @return The color palette value
+ * Fill the colours of the owners of tiles in the minimap screenshot.
+ * @param[out] owner_colours Palette value for each owner.
  */
-static void MinimapScreenCallback(void *userdata, void *buf, uint y, uint pitch, uint n)
+static void FillMinimapOwnerColours(byte (&owner_colours)[OWNER_END + 1])
 {
 	/* Fill with the company colours */
-	byte owner_colours[OWNER_END + 1];
 	for (const Company *c : Company::Iterate()) {
 		owner_colours[c->index] = MKCOLOUR(GetColourGradient(c->colour, SHADE_LIGHT));
 	}
@@ -1310,6 +1501,20 @@ static void MinimapScreenCallback(void *userdata, void *buf, uint y, uint pitch,
 	owner_colours[OWNER_WATER]   = PC_WATER;
 	owner_colours[OWNER_DEITY]   = PC_DARK_GREY; // industry
 	owner_colours[OWNER_END]     = PC_BLACK;
+}
+
+/**
+ * Callback for the minimap screenshot, colouring each tile by its owner.
+ * @param userdata Unused.
+ * @param buf Buffer to fill with the 32bpp pixels of the rows.
+ * @param y First row to fill.
+ * @param pitch Number of pixels per row.
+ * @param n Number of rows to fill.
+ */
+static void MinimapScreenCallback(void *userdata, void *buf, uint y, uint pitch, uint n)
+{
+	byte owner_colours[OWNER_END + 1];
+	FillMinimapOwnerColours(owner_colours);
 
 	MinimapScreenCallback(userdata, buf, y, pitch, n, [&](TileIndex tile) -> byte {
 		return owner_colours[GetMinimapOwner(tile)];
@@ -1361,3 +1566,156 @@ bool MakeIndustryScreenshot(const char *name)
 	const ScreenshotFormat *sf = _screenshot_formats + _cur_screenshot_format;
 	return sf->proc(MakeScreenshotName(SCREENSHOT_NAME, sf->extension), IndustryScreenCallback, nullptr, MapSizeX(), MapSizeY(), 32, _cur_palette.palette);
 }
+
+static const uint MAP_TILE_EXPORT_SIZE = 256; ///< Width and height in pixels of each exported map tile image.
+
+/** State of the incremental map tile export, see #ExportMapTiles. */
+struct MapTileExportState {
+	std::string path;            ///< Directory of the last export, empty if nothing has been exported in this game yet.
+	ScreenshotType type;         ///< Colouring of the last export.
+	uint blocks_x = 0;           ///< Number of tile images in the X direction at the most detailed level.
+	uint blocks_y = 0;           ///< Number of tile images in the Y direction at the most detailed level.
+	std::vector<bool> dirty;     ///< Tile images of the most detailed level whose map area has changed since the last export.
+};
+
+static MapTileExportState _map_tile_export;
+
+/**
+ * Mark the exported map tile image containing a tile as needing to be written again.
+ * @param tile The tile which has changed.
+ */
+void MarkMapTileExportDirty(TileIndex tile)
+{
+	if (_map_tile_export.path.empty()) return;
+
+	/* The exported images have the same orientation as the minimap screenshot, with the X axis reversed. */
+	uint bx = (MapMaxX() - TileX(tile)) / MAP_TILE_EXPORT_SIZE;
+	uint by = TileY(tile) / MAP_TILE_EXPORT_SIZE;
+	_map_tile_export.dirty[by * _map_tile_export.blocks_x + bx] = true;
+}
+
+/**
+ * Mark all exported map tile images as needing to be written again.
+ */
+void MarkAllMapTileExportDirty()
+{
+	_map_tile_export.dirty.assign(_map_tile_export.dirty.size(), true);
+}
+
+/**
+ * Forget the state of the previous map tile export, the next export writes all images.
+ */
+void ResetMapTileExport()
+{
+	_map_tile_export.path.clear();
+	_map_tile_export.dirty.clear();
+}
+
+/**
+ * Export the map as a pyramid of tile images for a web map, in the usual z/x/y.png layout.
+ * The most detailed level has one pixel per map tile, each less detailed level halves the resolution,
+ * down to level 0 which fits the whole map in one image.
+ * Only the images whose map area has changed since the previous export to the same directory are written,
+ * the images are rendered and written on the worker threads.
+ * @param name Name of the directory in the screenshot directory.
+ * @param type Colouring of the map, one of #SC_MINIMAP, #SC_TOPOGRAPHY or #SC_INDUSTRY.
+ * @param full Write all images, even those which have not changed.
+ * @param[out] written Number of images written.
+ * @return true if all images were written successfully.
+ */
+bool ExportMapTiles(const char *name, ScreenshotType type, bool full, uint &written)
+{
+	written = 0;
+#if defined(WITH_PNG)
+	MapTileExportState &state = _map_tile_export;
+
+	std::string path = FioGetDirectory(SP_AUTODOWNLOAD_DIR, SCREENSHOT_DIR);
+	path += name;
+	path += PATHSEP;
+
+	uint max_level = 0;
+	while ((MAP_TILE_EXPORT_SIZE << max_level) < std::max(MapSizeX(), MapSizeY())) max_level++;
+
+	uint blocks_x = CeilDiv(MapSizeX(), MAP_TILE_EXPORT_SIZE);
+	uint blocks_y = CeilDiv(MapSizeY(), MAP_TILE_EXPORT_SIZE);
+	if (full || state.path != path || state.type != type || state.blocks_x != blocks_x || state.blocks_y != blocks_y) {
+		state.path = path;
+		state.type = type;
+		state.blocks_x = blocks_x;
+		state.blocks_y = blocks_y;
+		state.dirty.assign(blocks_x * blocks_y, true);
+	}
+
+	/* Collect the images of each level which cover a changed area. */
+	struct MapTileExportJob {
+		uint level;
+		uint x;
+		uint y;
+	};
+	std::vector<MapTileExportJob> jobs;
+	for (uint level = 0; level <= max_level; level++) {
+		uint shift = max_level - level;
+		uint tiles_x = ((blocks_x - 1) >> shift) + 1;
+		uint tiles_y = ((blocks_y - 1) >> shift) + 1;
+		std::vector<bool> level_dirty(tiles_x * tiles_y, false);
+		std::vector<bool> column_created(tiles_x, false);
+		for (uint by = 0; by < blocks_y; by++) {
+			for (uint bx = 0; bx < blocks_x; bx++) {
+				if (!state.dirty[by * blocks_x + bx]) continue;
+				uint x = bx >> shift;
+				uint y = by >> shift;
+				if (level_dirty[y * tiles_x + x]) continue;
+				level_dirty[y * tiles_x + x] = true;
+				jobs.push_back({ level, x, y });
+				if (!column_created[x]) {
+					column_created[x] = true;
+					FioCreateDirectory(stdstr_fmt("%s%u" PATHSEP "%u", path.c_str(), level, x));
+				}
+			}
+		}
+	}
+	state.dirty.assign(blocks_x * blocks_y, false);
+
+	byte owner_colours[OWNER_END + 1];
+	FillMinimapOwnerColours(owner_colours);
+	auto get_colour = [&](TileIndex tile) -> byte {
+		switch (type) {
+			case SC_TOPOGRAPHY: return GetTopographyValue(tile);
+			case SC_INDUSTRY:   return GetIndustryValue(tile);
+			default:            return owner_colours[GetMinimapOwner(tile)];
+		}
+	};
+
+	std::atomic<uint> failed = 0;
+	_general_worker_pool.ParallelFor((uint)jobs.size(), [&](uint index) {
+		const MapTileExportJob &job = jobs[index];
+		uint shift = max_level - job.level;
+		uint scale = 1 << shift;
+
+		std::unique_ptr<uint8_t[]> pixels(new uint8_t[MAP_TILE_EXPORT_SIZE * MAP_TILE_EXPORT_SIZE]);
+		uint8_t *pixel = pixels.get();
+		for (uint py = 0; py < MAP_TILE_EXPORT_SIZE; py++) {
+			uint iy = (job.y * MAP_TILE_EXPORT_SIZE + py) << shift;
+			for (uint px = 0; px < MAP_TILE_EXPORT_SIZE; px++, pixel++) {
+				uint ix = (job.x * MAP_TILE_EXPORT_SIZE + px) << shift;
+				if (ix >= MapSizeX() || iy >= MapSizeY()) {
+					*pixel = PC_BLACK;
+					continue;
+				}
+				/* Sample the middle tile of the area covered by the pixel. */
+				uint x = std::min(ix + scale / 2, MapMaxX());
+				uint y = std::min(iy + scale / 2, MapMaxY());
+				*pixel = get_colour(TileXY(MapMaxX() - x, y));
+			}
+		}
+
+		std::string file = stdstr_fmt("%s%u" PATHSEP "%u" PATHSEP "%u.png", state.path.c_str(), job.level, job.x, job.y);
+		if (!WritePalettePNGFile(file.c_str(), pixels.get(), MAP_TILE_EXPORT_SIZE, MAP_TILE_EXPORT_SIZE, _cur_palette.palette)) failed++;
+	});
+
+	written = (uint)jobs.size() - failed;
+	return failed == 0;
+#else
+	return false;
+#endif /* WITH_PNG */
+}
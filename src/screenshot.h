@@ -10,6 +10,8 @@
 #ifndef SCREENSHOT_H
 #define SCREENSHOT_H
 
+#include "tile_type.h"
+
 void InitializeScreenshotFormats();
 
 const char *GetCurrentScreenshotExtension();
@@ -39,6 +41,10 @@ bool MakeScreenshot(ScreenshotType t, std::string name, uint32_t width = 0, uint
 bool MakeMinimapWorldScreenshot(const char *name);
 bool MakeTopographyScreenshot(const char *name);
 bool MakeIndustryScreenshot(const char *name);
+bool ExportMapTiles(const char *name, ScreenshotType type, bool full, uint &written);
+void MarkMapTileExportDirty(TileIndex tile);
+void MarkAllMapTileExportDirty();
+void ResetMapTileExport();
 void SetScreenshotAuxiliaryText(const char *key, const char *value);
 inline void ClearScreenshotAuxiliaryText() { SetScreenshotAuxiliaryText(nullptr, nullptr); }
 
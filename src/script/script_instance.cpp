@@ -748,6 +748,11 @@ SQInteger ScriptInstance::GetOpsTillSuspend()
 	return this->engine->GetOpsTillSuspend();
 }
 
+uint64_t ScriptInstance::GetExecutedOps() const
+{
+	return this->engine->GetExecutedOps();
+}
+
 void ScriptInstance::LimitOpsTillSuspend(SQInteger suspend)
 {
 	SQInteger current = this->GetOpsTillSuspend();
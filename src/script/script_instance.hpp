@@ -217,6 +217,12 @@ public:
 
 	void LimitOpsTillSuspend(SQInteger suspend);
 
+	/**
+	 * Get the number of operations the script executed so far.
+	 * @return The number of operations.
+	 */
+	uint64_t GetExecutedOps() const;
+
 	uint32_t GetMaxOpsTillSuspend() const;
 
 	/**
@@ -20,6 +20,7 @@
 #include "../network/network_content.h"
 #include "../3rdparty/md5/md5.h"
 #include "../tar_type.h"
+#include "../scan_index.h"
 #include "../core/format.hpp"
 
 #include "../safeguards.h"
@@ -171,18 +172,24 @@ struct ScriptFileChecksumCreator : FileScanner {
 		uint8_t buffer[1024];
 		size_t len, size;
 
+		std::string path;
+
 		/* Open the file ... */
-		FILE *f = FioFOpenFile(filename.c_str(), "rb", this->dir, &size);
+		FILE *f = FioFOpenFile(filename.c_str(), "rb", this->dir, &size, &path);
 		if (f == nullptr) return false;
 
-		/* ... calculate md5sum... */
-		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
-			size -= len;
-			checksum.Append(buffer, len);
-		}
-
+		/* ... look it up in the scan index, or calculate md5sum... */
 		MD5Hash tmp_md5sum;
-		checksum.Finish(tmp_md5sum);
+		ScanIndexKey index_key;
+		bool use_index = GetScanIndexKey(f, path, size, index_key);
+		if (!use_index || !LookupScanIndex(index_key, tmp_md5sum)) {
+			while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, f)) != 0 && size != 0) {
+				size -= len;
+				checksum.Append(buffer, len);
+			}
+			checksum.Finish(tmp_md5sum);
+			if (use_index) UpdateScanIndex(index_key, tmp_md5sum);
+		}
 
 		FioFCloseFile(f);
 
@@ -235,6 +242,8 @@ static bool IsSameScript(const ContentInfo *ci, bool md5sum, ScriptInfo *info, S
 		checksum.Scan(".nut", path);
 	}
 
+	SaveScanIndex();
+
 	return ci->md5sum == checksum.md5sum;
 }
 
@@ -395,6 +395,9 @@ bool Squirrel::Resume(int suspend)
 	assert(!this->crashed);
 	ScriptAllocatorScope alloc_scope(this);
 
+	this->executed_ops = this->GetExecutedOps();
+	this->resume_ops = 0;
+
 	/* Did we use more operations than we should have in the
 	 * previous tick? If so, subtract that from the current run. */
 	if (this->overdrawn_ops > 0 && suspend > 0) {
@@ -406,6 +409,7 @@ bool Squirrel::Resume(int suspend)
 		suspend = -this->overdrawn_ops;
 	}
 
+	this->resume_ops = suspend;
 	this->crashed = !sq_resumecatch(this->vm, suspend);
 	this->overdrawn_ops = -this->vm->_ops_till_suspend;
 	this->allocator->CheckLimit();
@@ -554,6 +558,8 @@ void Squirrel::Initialize()
 	this->print_func = nullptr;
 	this->crashed = false;
 	this->overdrawn_ops = 0;
+	this->resume_ops = 0;
+	this->executed_ops = 0;
 	this->vm = sq_open(1024);
 
 	/* Handle compile-errors ourself, so we can display it nicely */
@@ -846,3 +852,10 @@ SQInteger Squirrel::GetOpsTillSuspend()
 {
 	return this->vm->_ops_till_suspend;
 }
+
+uint64_t Squirrel::GetExecutedOps() const
+{
+	/* The operations of the last resume are counted down in the VM, also when it was left by an exception. */
+	if (this->resume_ops <= 0) return this->executed_ops;
+	return this->executed_ops + std::max<SQInteger>(0, this->resume_ops - this->vm->_ops_till_suspend);
+}
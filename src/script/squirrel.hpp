@@ -31,6 +31,8 @@ private:
 	SQPrintFunc *print_func; ///< Points to either nullptr, or a custom print handler
 	bool crashed;            ///< True if the squirrel script made an error.
 	int overdrawn_ops;       ///< The amount of operations we have overdrawn.
+	int resume_ops;          ///< The amount of operations the last resume was started with, 0 if it did not run.
+	uint64_t executed_ops;   ///< The amount of operations executed by all resumes before the last one.
 	const char *APIName;     ///< Name of the API used for this squirrel.
 	std::unique_ptr<ScriptAllocator> allocator; ///< Allocator object used by this script.
 
@@ -271,6 +273,12 @@ public:
 	 */
 	SQInteger GetOpsTillSuspend();
 
+	/**
+	 * How many operations were executed by resuming the script so far?
+	 * This is deterministic, unlike the time spent running the script.
+	 */
+	uint64_t GetExecutedOps() const;
+
 	/**
 	 * Completely reset the engine; start from scratch.
 	 */
@@ -2622,6 +2622,8 @@ static SettingsContainer &GetSettingsTree()
 				towns->Add(new SettingEntry("economy.town_cargo_scale_mode"));
 				towns->Add(new SettingEntry("economy.town_growth_rate"));
 				towns->Add(new SettingEntry("economy.town_growth_cargo_transported"));
+				towns->Add(new SettingEntry("economy.town_growth_frontier"));
+				towns->Add(new SettingEntry("economy.town_growth_parallel"));
 				towns->Add(new SettingEntry("economy.town_zone_calc_mode"));
 				towns->Add(new SettingEntry("economy.allow_town_roads"));
 				towns->Add(new SettingEntry("economy.allow_town_level_crossings"));
@@ -2701,6 +2703,7 @@ static SettingsContainer &GetSettingsTree()
 			{
 				npc->Add(new SettingEntry("script.script_max_opcode_till_suspend"));
 				npc->Add(new SettingEntry("script.script_max_memory_megabytes"));
+				npc->Add(new SettingEntry("script.script_tick_ops_budget"));
 				npc->Add(new SettingEntry("script.script_disable_param_randomisation"));
 				npc->Add(new SettingEntry("difficulty.competitor_speed"));
 				npc->Add(new SettingEntry("ai.ai_in_multiplayer"));
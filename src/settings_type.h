@@ -339,6 +339,8 @@ struct GUISettings : public TimeSettings {
 	uint8_t     newgrf_default_palette;                          ///< default palette to use for NewGRFs without action 14 palette information
 	bool        console_show_unlisted;                           ///< whether to show unlisted console commands
 	bool        newgrf_disable_big_gui;                          ///< whether to disable "big GUI" NewGRFs
+	bool        newgrf_read_ahead_cache;                         ///< whether to cache the sprite records of NewGRFs on disk, to speed up loading them
+	bool        scan_index;                                      ///< whether to remember the checksums of scanned content files, so that unchanged files need not be read again
 
 	bool        scale_bevels;                                    ///< bevels are scaled with GUI scale.
 	bool        bigger_main_toolbar;                             ///< bigger main toolbar.
@@ -429,6 +431,7 @@ struct NetworkSettings {
 	uint16_t      server_port;                            ///< port the server listens on
 	uint16_t      server_admin_port;                      ///< port the server listens on for the admin network
 	bool        server_admin_chat;                        ///< allow private chat for the server to be distributed to the admin network
+	uint16_t    admin_snapshot_interval;                  ///< minimum number of seconds between two game state snapshots sent to the same admin
 	ServerGameType server_game_type;                      ///< Server type: local / public / invite-only.
 	std::string server_invite_code;                       ///< Invite code to use when registering as server.
 	std::string server_invite_code_secret;                ///< Secret to proof we got this invite code from the Game Coordinator.
@@ -569,6 +572,7 @@ struct ScriptSettings {
 	uint32_t script_max_opcode_till_suspend;   ///< max opcode calls till scripts will suspend
 	uint32_t script_max_memory_megabytes;      ///< limit on memory a single script instance may have allocated
 	bool     script_disable_param_randomisation; ///< disable script parameter randomisation
+	uint32_t script_tick_ops_budget;           ///< max script operations all AIs may execute per tick before AIs and the game script are deferred, 0 = unlimited
 };
 
 /** Settings related to the new pathfinder. */
@@ -743,6 +747,8 @@ struct EconomySettings {
 	int8_t   town_growth_rate;               ///< town growth rate
 	uint8_t  town_growth_cargo_transported;  ///< percentage of town growth rate which depends on proportion of transported cargo in the last month
 	bool     town_zone_calc_mode;            ///< calc mode for town zones
+	bool     town_growth_frontier;           ///< towns first try to grow where they recently grew, instead of searching from the centre
+	bool     town_growth_parallel;           ///< search for places to grow for all towns concurrently
 	uint16_t town_zone_0_mult;               ///< multiplier for the size of town zone 0
 	uint16_t town_zone_1_mult;               ///< multiplier for the size of town zone 1
 	uint16_t town_zone_2_mult;               ///< multiplier for the size of town zone 2
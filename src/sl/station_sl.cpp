@@ -308,7 +308,7 @@ SaveLoadTable GetGoodsDesc()
 	return goods_desc;
 }
 
-typedef std::pair<const StationID, CargoPacketList> StationCargoPair;
+typedef StationCargoPacketMap::value_type StationCargoPair;
 
 static const SaveLoad _cargo_list_desc[] = {
 	SLE_VAR(StationCargoPair, first,  SLE_UINT16),
@@ -327,7 +327,7 @@ static void SwapPackets(GoodsEntry *ge)
 	StationCargoPacketMap &ge_packets = const_cast<StationCargoPacketMap &>(*ge->CreateData().cargo.Packets());
 
 	if (_packets.empty()) {
-		std::map<StationID, CargoPacketList>::iterator it(ge_packets.find(INVALID_STATION));
+		StationCargoPacketMap::MapIterator it(ge_packets.find(INVALID_STATION));
 		if (it == ge_packets.end()) {
 			return;
 		} else {
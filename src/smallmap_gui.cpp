@@ -28,6 +28,7 @@
 #include "object_map.h"
 #include "newgrf_object.h"
 #include "blitter/factory.hpp"
+#include "worker_thread.h"
 
 #include "smallmap_colours.h"
 #include "smallmap_gui.h"
@@ -167,6 +168,120 @@ static bool _smallmap_industry_highlight_state;
 /** For connecting company ID to position in owner list (small map legend) */
 uint _company_to_list_pos[MAX_COMPANIES];
 
+/**
+ * Cache of the colours of the groups of tiles shown as one smallmap cell, for one map type and tile zoom.
+ * Cells are stored in chunks which are only allocated when they are first drawn.
+ * Cells are invalidated individually when their tiles are marked dirty, see #MarkSmallMapTileDirty,
+ * and the whole cache is cleared when anything else which affects the colours changes.
+ */
+struct SmallMapTileColourCache {
+	static constexpr uint CHUNK_SHIFT = 6;                 ///< Log2 of the number of cells along each side of a chunk.
+	static constexpr uint CHUNK_SIZE = 1 << CHUNK_SHIFT;   ///< Number of cells along each side of a chunk.
+	static constexpr uint CHUNK_MASK = CHUNK_SIZE - 1;     ///< Mask of the cell coordinate within a chunk.
+	static constexpr uint MAX_CHUNKS = 1024;               ///< Clear the cache when more than this many chunks have been allocated.
+
+	/** Colours of a square of cells. */
+	struct Chunk {
+		uint32_t colours[CHUNK_SIZE * CHUNK_SIZE]; ///< Cell colours.
+		bool valid[CHUNK_SIZE * CHUNK_SIZE];       ///< Whether the cell colour is valid, one byte per cell so that cells can be filled concurrently.
+	};
+
+	SmallMapType map_type = SMT_CONTOUR;        ///< Map type of the cached colours.
+	int tile_zoom = 0;                          ///< Tile zoom of the cached colours, 0 if the cache is not in use.
+	uint chunks_x = 0;                          ///< Number of chunks in the X direction.
+	uint chunks_y = 0;                          ///< Number of chunks in the Y direction.
+	uint allocated_chunks = 0;                  ///< Number of allocated chunks.
+	std::vector<std::unique_ptr<Chunk>> chunks; ///< Chunks, nullptr if not yet allocated.
+
+	void Clear()
+	{
+		this->tile_zoom = 0;
+		this->allocated_chunks = 0;
+		this->chunks.clear();
+	}
+
+	/**
+	 * Prepare the cache for drawing a map type at a tile zoom, clearing it if it is for anything else.
+	 * @param map_type Map type to draw.
+	 * @param tile_zoom Tile zoom to draw.
+	 */
+	void Prepare(SmallMapType map_type, int tile_zoom)
+	{
+		if (this->tile_zoom == tile_zoom && this->map_type == map_type && this->allocated_chunks <= MAX_CHUNKS) return;
+
+		this->Clear();
+		this->map_type = map_type;
+		this->tile_zoom = tile_zoom;
+		uint cells_x = CeilDiv(MapSizeX(), tile_zoom);
+		uint cells_y = CeilDiv(MapSizeY(), tile_zoom);
+		this->chunks_x = CeilDiv(cells_x, CHUNK_SIZE);
+		this->chunks_y = CeilDiv(cells_y, CHUNK_SIZE);
+		this->chunks.resize(this->chunks_x * this->chunks_y);
+	}
+
+	/**
+	 * Get the chunk of a cell, allocating it if necessary.
+	 * @param cx X coordinate of the cell.
+	 * @param cy Y coordinate of the cell.
+	 * @return The chunk.
+	 */
+	Chunk *GetOrAllocateChunk(uint cx, uint cy)
+	{
+		std::unique_ptr<Chunk> &chunk = this->chunks[(cy >> CHUNK_SHIFT) * this->chunks_x + (cx >> CHUNK_SHIFT)];
+		if (chunk == nullptr) {
+			chunk.reset(new Chunk());
+			this->allocated_chunks++;
+		}
+		return chunk.get();
+	}
+
+	/**
+	 * Get the chunk of a cell, the chunk must already be allocated.
+	 * @param cx X coordinate of the cell.
+	 * @param cy Y coordinate of the cell.
+	 * @return The chunk.
+	 */
+	inline Chunk *GetChunk(uint cx, uint cy) const
+	{
+		return this->chunks[(cy >> CHUNK_SHIFT) * this->chunks_x + (cx >> CHUNK_SHIFT)].get();
+	}
+
+	static inline uint GetCellIndex(uint cx, uint cy)
+	{
+		return ((cy & CHUNK_MASK) << CHUNK_SHIFT) | (cx & CHUNK_MASK);
+	}
+
+	void MarkTileDirty(TileIndex tile)
+	{
+		if (this->tile_zoom == 0) return;
+
+		uint cx = TileX(tile) / this->tile_zoom;
+		uint cy = TileY(tile) / this->tile_zoom;
+		Chunk *chunk = this->GetChunk(cx, cy);
+		if (chunk != nullptr) chunk->valid[GetCellIndex(cx, cy)] = false;
+	}
+};
+
+/** Tile colour cache of the smallmap window. */
+static SmallMapTileColourCache _smallmap_tile_colour_cache;
+
+/**
+ * Mark the smallmap colour of a tile as needing to be recalculated.
+ * @param tile The tile which has changed.
+ */
+void MarkSmallMapTileDirty(TileIndex tile)
+{
+	_smallmap_tile_colour_cache.MarkTileDirty(tile);
+}
+
+/**
+ * Clear all cached smallmap colours.
+ */
+void ClearSmallMapTileColourCache()
+{
+	_smallmap_tile_colour_cache.Clear();
+}
+
 static void NotifyAllViewports(ViewportMapType map_type)
 {
 	for (Window *w : Window::Iterate()) {
@@ -790,6 +905,74 @@ inline uint32_t SmallMapWindow::GetTileColours(const TileArea &ta) const
 	}
 }
 
+/**
+ * Get the tiles shown by one smallmap cell.
+ * @param xc The X coordinate of the first tile of the cell.
+ * @param yc The Y coordinate of the first tile of the cell.
+ * @param[out] ta Tile area of the cell.
+ * @return false if the cell has no tiles.
+ */
+inline bool SmallMapWindow::GetCellTileArea(uint xc, uint yc, TileArea &ta) const
+{
+	uint min_xy = _settings_game.construction.freeform_edges ? 1 : 0;
+
+	/* Construct tilearea covered by (xc, yc, xc + this->zoom, yc + this->zoom) such that it is within min_xy limits. */
+	if (min_xy == 1 && (xc == 0 || yc == 0)) {
+		if (this->tile_zoom == 1) return false; // The tile area is empty, don't draw anything.
+		ta = TileArea(TileXY(std::max(min_xy, xc), std::max(min_xy, yc)), this->tile_zoom - (xc == 0), this->tile_zoom - (yc == 0));
+	} else {
+		ta = TileArea(TileXY(xc, yc), this->tile_zoom, this->tile_zoom);
+	}
+	ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
+	return true;
+}
+
+/**
+ * Make sure that the tile colour cache has valid colours for all cells of the given columns.
+ * Missing colours are calculated on the worker threads when there are enough of them, such as when the window is first opened.
+ * @param columns Columns which are about to be drawn.
+ */
+void SmallMapWindow::FillTileColourCache(const std::vector<SmallMapColumn> &columns) const
+{
+	SmallMapTileColourCache &cache = _smallmap_tile_colour_cache;
+	cache.Prepare(this->map_type, this->tile_zoom);
+
+	/* Allocate the chunks and collect the invalid cells on this thread. */
+	std::vector<std::pair<uint, uint>> pending;
+	for (const SmallMapColumn &column : columns) {
+		uint xc = column.tile_x;
+		uint yc = column.tile_y;
+		for (int i = 0; i < column.reps; i++, xc += this->tile_zoom, yc += this->tile_zoom) {
+			if (xc >= MapMaxX() || yc >= MapMaxY()) continue;
+			uint cx = xc / this->tile_zoom;
+			uint cy = yc / this->tile_zoom;
+			if (!cache.GetOrAllocateChunk(cx, cy)->valid[SmallMapTileColourCache::GetCellIndex(cx, cy)]) pending.emplace_back(xc, yc);
+		}
+	}
+	if (pending.empty()) return;
+
+	/* Each cell is only written by one job, so no locking is required. */
+	auto fill_cell = [&](std::pair<uint, uint> cell) {
+		uint cx = cell.first / this->tile_zoom;
+		uint cy = cell.second / this->tile_zoom;
+		SmallMapTileColourCache::Chunk *chunk = cache.GetChunk(cx, cy);
+		uint index = SmallMapTileColourCache::GetCellIndex(cx, cy);
+		TileArea ta;
+		chunk->colours[index] = this->GetCellTileArea(cell.first, cell.second, ta) ? this->GetTileColours(ta) : 0;
+		chunk->valid[index] = true;
+	};
+
+	static const uint CELLS_PER_JOB = 1024;
+	if (pending.size() <= CELLS_PER_JOB) {
+		for (const auto &cell : pending) fill_cell(cell);
+	} else {
+		_general_worker_pool.ParallelFor(CeilDiv((uint)pending.size(), CELLS_PER_JOB), [&](uint job) {
+			size_t end = std::min<size_t>(pending.size(), (job + 1) * CELLS_PER_JOB);
+			for (size_t i = job * CELLS_PER_JOB; i < end; i++) fill_cell(pending[i]);
+		});
+	}
+}
+
 /**
  * Draws one column of tiles of the small map in a certain mode onto the screen buffer, skipping the shifted rows in between.
  *
@@ -801,9 +984,10 @@ inline uint32_t SmallMapWindow::GetTileColours(const TileArea &ta) const
  * @param start_pos Position of first pixel to draw.
  * @param end_pos Position of last pixel to draw (exclusive).
  * @param blitter current blitter
+ * @param use_cache Take the colours from the tile colour cache, which must have been filled by #FillTileColourCache.
  * @note If pixel position is below \c 0, skip drawing.
  */
-void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, int y, int end_y, Blitter *blitter) const
+void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, int y, int end_y, Blitter *blitter, bool use_cache) const
 {
 	void *dst_ptr_abs_end = blitter->MoveTo(_screen.dst_ptr, 0, _screen.height);
 	uint min_xy = _settings_game.construction.freeform_edges ? 1 : 0;
@@ -820,17 +1004,17 @@ void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch,
 		if (dst < _screen.dst_ptr) continue;
 		if (dst >= dst_ptr_abs_end) continue;
 
-		/* Construct tilearea covered by (xc, yc, xc + this->zoom, yc + this->zoom) such that it is within min_xy limits. */
-		TileArea ta;
-		if (min_xy == 1 && (xc == 0 || yc == 0)) {
-			if (this->tile_zoom == 1) continue; // The tile area is empty, don't draw anything.
-			ta = TileArea(TileXY(std::max(min_xy, xc), std::max(min_xy, yc)), this->tile_zoom - (xc == 0), this->tile_zoom - (yc == 0));
+		uint32_t val;
+		if (use_cache) {
+			if (min_xy == 1 && (xc == 0 || yc == 0) && this->tile_zoom == 1) continue; // The tile area is empty, don't draw anything.
+			uint cx = xc / this->tile_zoom;
+			uint cy = yc / this->tile_zoom;
+			val = _smallmap_tile_colour_cache.GetChunk(cx, cy)->colours[SmallMapTileColourCache::GetCellIndex(cx, cy)];
 		} else {
-			ta = TileArea(TileXY(xc, yc), this->tile_zoom, this->tile_zoom);
+			TileArea ta;
+			if (!this->GetCellTileArea(xc, yc, ta)) continue;
+			val = this->GetTileColours(ta);
 		}
-		ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
-
-		uint32_t val = this->GetTileColours(ta);
 		uint8_t *val8 = (uint8_t *)&val;
 		if (this->ui_zoom == 1) {
 			int idx = std::max(0, -start_pos);
@@ -953,8 +1137,10 @@ void SmallMapWindow::DrawMapIndicators() const
  * <li>Town names (optional)</li></ol>
  *
  * @param dpi pointer to pixel to write onto
+ * @param draw_indicators Whether to draw the main viewport indicators.
+ * @param use_cache Whether to use and update the tile colour cache, this should be false when drawing the whole map at once.
  */
-void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) const
+void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators, bool use_cache) const
 {
 	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
 	AutoRestoreBackup dpi_backup(_cur_dpi, dpi);
@@ -977,6 +1163,7 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 	void *ptr = blitter->MoveTo(dpi->dst_ptr, x, y);
 	bool even = true;
 
+	std::vector<SmallMapColumn> columns;
 	for (;;) {
 		/* Distance from left edge */
 		if (x > -4 * this->ui_zoom) {
@@ -985,7 +1172,7 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 			int end_pos = std::min(dpi->width, x + 4 * this->ui_zoom);
 			int reps = (dpi->height - y + 3 * this->ui_zoom - 1) / 2 / this->ui_zoom; // Number of lines.
 			if (reps > 0) {
-				this->DrawSmallMapColumn(ptr, tile_x, tile_y, dpi->pitch, reps, x, end_pos, y, dpi->height, blitter);
+				columns.push_back({ ptr, tile_x, tile_y, reps, x, end_pos, y });
 			}
 		}
 		if (even) {
@@ -1002,6 +1189,12 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators) cons
 		x += 2 * this->ui_zoom;
 	}
 
+	if (use_cache) this->FillTileColourCache(columns);
+
+	for (const SmallMapColumn &column : columns) {
+		this->DrawSmallMapColumn(column.ptr, column.tile_x, column.tile_y, dpi->pitch, column.reps, column.x, column.end_pos, column.y, dpi->height, blitter, use_cache);
+	}
+
 	/* Draw vehicles */
 	if (this->map_type == SMT_CONTOUR || this->map_type == SMT_VEHICLES) this->DrawVehicles(dpi, blitter);
 
@@ -1066,6 +1259,7 @@ void SmallMapWindow::SetupWidgetData()
 SmallMapWindow::SmallMapWindow(WindowDesc *desc, int window_number) : Window(desc), refresh(GUITimer())
 {
 	_smallmap_industry_highlight = INVALID_INDUSTRYTYPE;
+	_smallmap_tile_colour_cache.Clear();
 	this->overlay = std::make_unique<LinkGraphOverlay>(this, WID_SM_MAP, 0, this->GetOverlayCompanyMask(), 1);
 	this->InitNested(window_number);
 	this->LowerWidget(WID_SM_CONTOUR + this->map_type);
@@ -1087,6 +1281,7 @@ SmallMapWindow::SmallMapWindow(WindowDesc *desc, int window_number) : Window(des
 /* virtual */ void SmallMapWindow::Close([[maybe_unused]] int data)
 {
 	this->BreakIndustryChainLink();
+	_smallmap_tile_colour_cache.Clear();
 	this->Window::Close();
 }
 
@@ -1113,6 +1308,7 @@ void SmallMapWindow::RebuildColourIndexIfNecessary()
 
 	SmallMapWindow::map_height_limit = _settings_game.construction.map_height_limit;
 	BuildLandLegend();
+	_smallmap_tile_colour_cache.Clear();
 }
 
 /* virtual */ void SmallMapWindow::SetStringParameters(WidgetID widget) const
@@ -1404,6 +1600,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 	}
 	if (new_highlight != _smallmap_industry_highlight) {
 		_smallmap_industry_highlight = new_highlight;
+		_smallmap_tile_colour_cache.Clear();
 		this->refresh.SetInterval(this->GetRefreshPeriod());
 		_smallmap_industry_highlight_state = true;
 		this->SetDirty();
@@ -1481,6 +1678,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 						NotifyAllViewports(VPMT_OWNER);
 					}
 				}
+				_smallmap_tile_colour_cache.Clear();
 				this->SetDirty();
 			}
 			break;
@@ -1508,6 +1706,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 				tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 			}
 			if (this->map_type == SMT_LINKSTATS) this->SetOverlayCargoMask();
+			_smallmap_tile_colour_cache.Clear();
 			this->SetDirty();
 			break;
 		}
@@ -1515,6 +1714,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 		case WID_SM_SHOW_HEIGHT: // Enable/disable showing of heightmap.
 			_smallmap_show_heightmap = !_smallmap_show_heightmap;
 			this->SetWidgetLoweredState(WID_SM_SHOW_HEIGHT, _smallmap_show_heightmap);
+			_smallmap_tile_colour_cache.Clear();
 			this->SetDirty();
 			break;
 
@@ -1553,6 +1753,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 
 		default: NOT_REACHED();
 	}
+	_smallmap_tile_colour_cache.Clear();
 	this->SetDirty();
 }
 
@@ -1593,6 +1794,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 		}
 	}
 	_smallmap_industry_highlight_state = !_smallmap_industry_highlight_state;
+	if (this->map_type == SMT_INDUSTRY && _smallmap_industry_highlight != INVALID_INDUSTRYTYPE) _smallmap_tile_colour_cache.Clear();
 
 	this->refresh.SetInterval(this->GetRefreshPeriod());
 	this->SetDirty();
@@ -1723,7 +1925,7 @@ void SmallMapWindow::ScreenshotCallbackHandler(void *buf, uint y, uint pitch, ui
 	this->scroll_y = 0;
 
 	/* make the screenshot */
-	this->DrawSmallMap(&dpi, false);
+	this->DrawSmallMap(&dpi, false, false);
 }
 
 SmallMapType SmallMapWindow::map_type = SMT_CONTOUR;
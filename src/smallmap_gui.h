@@ -52,6 +52,8 @@ void BuildIndustriesLegend();
 void ShowSmallMap();
 void BuildLandLegend();
 void BuildOwnerLegend();
+void MarkSmallMapTileDirty(TileIndex tile);
+void ClearSmallMapTileColourCache();
 
 /** Structure for holding relevant data for legends in small map */
 struct LegendAndColour {
@@ -111,6 +113,17 @@ protected:
 	GUITimer refresh; ///< Refresh timer.
 	std::unique_ptr<LinkGraphOverlay> overlay;
 
+	/** One column of tiles of the small map, see #DrawSmallMapColumn. */
+	struct SmallMapColumn {
+		void *ptr;    ///< Pointer to the first pixel of the column in the screen buffer.
+		int tile_x;   ///< X coordinate of the first tile in the column.
+		int tile_y;   ///< Y coordinate of the first tile in the column.
+		int reps;     ///< Number of lines to draw.
+		int x;        ///< Position of the first pixel to draw.
+		int end_pos;  ///< Position of the last pixel to draw (exclusive).
+		int y;        ///< Y position of the first line.
+	};
+
 	static void BreakIndustryChainLink();
 
 	/**
@@ -183,16 +196,18 @@ protected:
 	uint PausedAdjustRefreshTimeDelta(uint delta_ms) const;
 
 	void DrawMapIndicators() const;
-	void DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, int y, int end_y, Blitter *blitter) const;
+	void FillTileColourCache(const std::vector<SmallMapColumn> &columns) const;
+	void DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch, int reps, int start_pos, int end_pos, int y, int end_y, Blitter *blitter, bool use_cache) const;
 	void DrawVehicles(const DrawPixelInfo *dpi, Blitter *blitter) const;
 	void DrawTowns(const DrawPixelInfo *dpi) const;
-	void DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators = true) const;
+	void DrawSmallMap(DrawPixelInfo *dpi, bool draw_indicators = true, bool use_cache = true) const;
 
 	Point TileToPixel(int tx, int ty) const;
 	Point PixelToTile(int px, int py) const;
 	void SetZoomLevel(ZoomLevelChange change, const Point *zoom_pt);
 	void SetOverlayCargoMask();
 	void SetupWidgetData();
+	bool GetCellTileArea(uint xc, uint yc, TileArea &ta) const;
 	uint32_t GetTileColours(const TileArea &ta) const;
 
 	int GetPositionOnLegend(Point pt);
@@ -81,6 +81,11 @@ bool DecodeSingleSprite(SpriteLoader::Sprite *sprite, SpriteFile &file, size_t f
 			int size = (code == 0) ? 0x80 : code;
 			num -= size;
 			if (num < 0) return WarnCorruptSprite(file, file_pos, __LINE__);
+			if (const byte *src = file.ReadBlockView(size); src != nullptr) {
+				memcpy(dest, src, size);
+				dest += size;
+				continue;
+			}
 			for (; size > 0; size--) {
 				*dest = file.ReadByte();
 				dest++;
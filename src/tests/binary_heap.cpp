@@ -0,0 +1,80 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file binary_heap.cpp Test functionality from pathfinder/npf/queue.h */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../pathfinder/npf/queue.h"
+
+#include <map>
+
+static std::map<uint32_t, int> FillHeap(BinaryHeap &heap)
+{
+	std::map<uint32_t, int> reference;
+	uint32_t seed = 12345;
+	for (uint32_t item = 0; item < 500; item++) {
+		seed = seed * 1103515245 + 12345;
+		int priority = (seed >> 16) % 100;
+		CHECK(heap.Push(item, priority));
+		reference[item] = priority;
+	}
+	CHECK(heap.size == 500);
+	return reference;
+}
+
+TEST_CASE("BinaryHeap - push and pop")
+{
+	BinaryHeap heap;
+	heap.Init(1000);
+	std::map<uint32_t, int> reference = FillHeap(heap);
+
+	int last_priority = INT_MIN;
+	while (heap.size > 0) {
+		uint32_t item = heap.Pop();
+		auto it = reference.find(item);
+		REQUIRE(it != reference.end());
+		CHECK(it->second >= last_priority);
+		last_priority = it->second;
+		reference.erase(it);
+	}
+	CHECK(reference.empty());
+	CHECK(heap.Pop() == UINT32_MAX);
+
+	/* The heap is reusable after clearing. */
+	CHECK(heap.Push(7, 1));
+	heap.Clear();
+	CHECK(heap.size == 0);
+	CHECK(heap.Push(7, 1));
+	CHECK(heap.Pop() == 7);
+	heap.Free();
+}
+
+TEST_CASE("BinaryHeap - delete")
+{
+	BinaryHeap heap;
+	heap.Init(1000);
+	std::map<uint32_t, int> reference = FillHeap(heap);
+
+	/* Delete every third item. */
+	for (uint32_t item = 0; item < 500; item += 3) {
+		CHECK(heap.Delete(item, reference[item]));
+		CHECK_FALSE(heap.Delete(item, reference[item]));
+		reference.erase(item);
+	}
+	CHECK_FALSE(heap.Delete(5000, 0));
+	CHECK(heap.size == reference.size());
+
+	/* Every remaining item is returned exactly once. */
+	while (heap.size > 0) {
+		CHECK(reference.erase(heap.Pop()) == 1);
+	}
+	CHECK(reference.empty());
+	heap.Free();
+}
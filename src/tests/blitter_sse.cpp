@@ -0,0 +1,185 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file blitter_sse.cpp Test and benchmark the SSE and AVX2 32bpp blitters against each other. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#if defined(WITH_SSE) && !defined(DEDICATED)
+
+#include "../blitter/32bpp_avx2.hpp"
+#include "../blitter/32bpp_sse2.hpp"
+#include "../blitter/32bpp_sse4.hpp"
+#include "../gfx_func.h"
+#include "../spritecache.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+static const BlitterMode TEST_BLITTER_MODES[] = {
+	BM_NORMAL, BM_COLOUR_REMAP, BM_TRANSPARENT, BM_TRANSPARENT_REMAP, BM_CRASH_REMAP, BM_BLACK_REMAP, BM_NORMAL_WITH_BRIGHTNESS, BM_COLOUR_REMAP_WITH_BRIGHTNESS,
+};
+
+/** Simple deterministic pseudo random generator, so that failures are reproducible. */
+struct TestBlitterRandom {
+	uint32_t state;
+
+	uint32_t Next()
+	{
+		this->state = this->state * 1103515245 + 12345;
+		return this->state >> 8;
+	}
+};
+
+/**
+ * Make a sprite in the format of a sprite loader, with runs of transparent, opaque, translucent and remapped pixels.
+ * @param width Width of the sprite.
+ * @param height Height of the sprite.
+ * @param rnd Random generator.
+ * @return Pixels of the sprite.
+ */
+static std::vector<SpriteLoader::CommonPixel> MakeTestSpritePixels(uint width, uint height, TestBlitterRandom &rnd)
+{
+	std::vector<SpriteLoader::CommonPixel> pixels(width * height);
+	for (uint y = 0; y < height; y++) {
+		uint x = 0;
+		while (x < width) {
+			uint run = 1 + rnd.Next() % 12;
+			uint kind = rnd.Next() % 4;
+			for (; run > 0 && x < width; run--, x++) {
+				SpriteLoader::CommonPixel &px = pixels[y * width + x];
+				px.r = rnd.Next();
+				px.g = rnd.Next();
+				px.b = rnd.Next();
+				px.a = (kind == 0) ? 0 : (kind == 1 ? 255 : rnd.Next());
+				px.m = (kind == 3) ? rnd.Next() : 0;
+			}
+		}
+	}
+	return pixels;
+}
+
+static void *TestBlitterSpriteAllocate(size_t size)
+{
+	return MallocT<byte>(size);
+}
+
+/** A sprite encoded for a blitter, and the destination buffer to draw it to. */
+struct TestBlitterCase {
+	std::unique_ptr<Sprite, FreeDeleter> sprite;
+	uint width;
+	uint height;
+	std::vector<uint32_t> dst;
+	uint pitch;
+
+	TestBlitterCase(Blitter *blitter, uint width, uint height, uint32_t seed) : width(width), height(height)
+	{
+		TestBlitterRandom rnd{ seed };
+		std::vector<SpriteLoader::CommonPixel> pixels = MakeTestSpritePixels(width, height, rnd);
+
+		/* Font sprites only have the normal zoom level, which avoids depending on the zoom settings. */
+		SpriteLoader::SpriteCollection collection{};
+		collection[ZOOM_LVL_NORMAL].width = width;
+		collection[ZOOM_LVL_NORMAL].height = height;
+		collection[ZOOM_LVL_NORMAL].type = SpriteType::Font;
+		collection[ZOOM_LVL_NORMAL].colours = (SpriteColourComponent)(SCC_RGB | SCC_ALPHA | SCC_PAL);
+		collection[ZOOM_LVL_NORMAL].data = pixels.data();
+		this->sprite.reset(blitter->Encode(collection, TestBlitterSpriteAllocate));
+
+		this->pitch = width + 16;
+		this->dst.resize(this->pitch * (height + 2));
+		for (uint32_t &px : this->dst) px = rnd.Next() | (rnd.Next() << 24);
+	}
+
+	void Draw(Blitter *blitter, BlitterMode mode, const byte *remap, uint skip_left, std::vector<uint32_t> &out) const
+	{
+		out = this->dst;
+
+		Blitter::BlitterParams bp;
+		bp.sprite = this->sprite->data;
+		bp.remap = remap;
+		bp.brightness_adjust = 20;
+		bp.skip_left = skip_left;
+		bp.skip_top = 1;
+		bp.width = this->width - skip_left;
+		bp.height = this->height - 1;
+		bp.sprite_width = this->width;
+		bp.sprite_height = this->height;
+		bp.left = 3;
+		bp.top = 1;
+		bp.dst = out.data();
+		bp.pitch = this->pitch;
+		blitter->Draw(&bp, mode, ZOOM_LVL_NORMAL);
+	}
+};
+
+static void SetupTestBlitterPalette(std::array<byte, 256> &remap)
+{
+	TestBlitterRandom rnd{ 42 };
+	for (uint i = 0; i < 256; i++) {
+		_cur_palette.palette[i] = Colour(rnd.Next(), rnd.Next(), rnd.Next());
+		remap[i] = (i % 7 == 0) ? 0 : rnd.Next();
+	}
+	_cur_palette.palette[0] = Colour(0, 0, 0, 0);
+}
+
+TEST_CASE("Blitter - AVX2 draws the same as SSE4")
+{
+	if (!HasCPUAVX2Support() || !HasCPUIDFlag(1, 2, 19)) return;
+
+	std::array<byte, 256> remap;
+	SetupTestBlitterPalette(remap);
+
+	Blitter_32bppSSE4 sse4;
+	Blitter_32bppAVX2 avx2;
+
+	for (uint width : { 1, 2, 7, 8, 9, 16, 23, 64, 131 }) {
+		TestBlitterCase test_case(&sse4, width, 9, width * 7919);
+		for (BlitterMode mode : TEST_BLITTER_MODES) {
+			for (uint skip_left : { 0, 1 }) {
+				if (skip_left >= width) continue;
+				std::vector<uint32_t> expected;
+				std::vector<uint32_t> actual;
+				test_case.Draw(&sse4, mode, remap.data(), skip_left, expected);
+				test_case.Draw(&avx2, mode, remap.data(), skip_left, actual);
+				INFO("width: " << width << ", mode: " << mode << ", skip_left: " << skip_left);
+				CHECK(expected == actual);
+			}
+		}
+	}
+}
+
+TEST_CASE("Blitter - SSE and AVX2 benchmark", "[.][bench]")
+{
+	std::array<byte, 256> remap;
+	SetupTestBlitterPalette(remap);
+
+	std::vector<std::pair<const char *, std::unique_ptr<Blitter>>> blitters;
+	if (HasCPUIDFlag(1, 3, 26)) blitters.emplace_back("32bpp-sse2", std::make_unique<Blitter_32bppSSE2>());
+	if (HasCPUIDFlag(1, 2, 19)) blitters.emplace_back("32bpp-sse4", std::make_unique<Blitter_32bppSSE4>());
+	if (HasCPUAVX2Support()) blitters.emplace_back("32bpp-avx2", std::make_unique<Blitter_32bppAVX2>());
+
+	const uint width = 256;
+	const uint height = 64;
+	const uint iterations = 2000;
+	for (auto &it : blitters) {
+		TestBlitterCase test_case(it.second.get(), width, height, 1234);
+		std::vector<uint32_t> out;
+		for (BlitterMode mode : TEST_BLITTER_MODES) {
+			auto start = std::chrono::steady_clock::now();
+			for (uint i = 0; i < iterations; i++) test_case.Draw(it.second.get(), mode, remap.data(), 0, out);
+			auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			uint64_t pixels = (uint64_t)iterations * width * (height - 1);
+			WARN(it.first << " mode " << mode << ": " << (pixels / std::max<int64_t>(1, duration.count())) << " Mpix/s");
+		}
+	}
+}
+
+#endif /* WITH_SSE && !DEDICATED */
@@ -0,0 +1,216 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file flat_map.cpp Test functionality from core/flat_map.hpp */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/flat_map.hpp"
+#include "../core/multimap.hpp"
+#include "../core/ring_buffer.hpp"
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+using TestFlatMap = flat_map<uint16_t, ring_buffer<uint32_t>, 4>;
+
+static bool MatchesKeys(const TestFlatMap &map, std::initializer_list<uint16_t> keys)
+{
+	if (map.size() != keys.size()) return false;
+	auto it = map.begin();
+	for (uint16_t key : keys) {
+		if (it->first != key) return false;
+		++it;
+	}
+	return true;
+}
+
+TEST_CASE("FlatMap - insert and lookup")
+{
+	TestFlatMap map;
+	CHECK(map.empty());
+
+	map[5].push_back(50);
+	map[2].push_back(20);
+	map[9].push_back(90);
+	map[2].push_back(21);
+	CHECK(MatchesKeys(map, { 2, 5, 9 }));
+	CHECK(map.capacity() == 4);
+
+	CHECK(map.find(2)->second.size() == 2);
+	CHECK(map.find(3) == map.end());
+	CHECK(map.lower_bound(3)->first == 5);
+	CHECK(map.upper_bound(5)->first == 9);
+	CHECK(map.contains(9));
+
+	/* Grow beyond the inline storage */
+	map[1].push_back(10);
+	map[7].push_back(70);
+	map[0xFFFF].push_back(1);
+	CHECK(MatchesKeys(map, { 1, 2, 5, 7, 9, 0xFFFF }));
+	CHECK(map.capacity() > 4);
+	CHECK(map.find(2)->second[1] == 21);
+	CHECK(map.find(7)->second[0] == 70);
+}
+
+TEST_CASE("FlatMap - erase")
+{
+	TestFlatMap map;
+	for (uint16_t key : { 4, 3, 2, 1, 6, 5 }) map[key].push_back(key);
+
+	auto it = map.erase(map.find(3));
+	CHECK(it->first == 4);
+	CHECK(map.erase(6) == 1);
+	CHECK(map.erase(6) == 0);
+	CHECK(MatchesKeys(map, { 1, 2, 4, 5 }));
+	for (const auto &item : map) {
+		CHECK(item.second.size() == 1);
+		CHECK(item.second.front() == item.first);
+	}
+
+	map.clear();
+	CHECK(map.empty());
+	CHECK(map.capacity() == 4);
+}
+
+TEST_CASE("FlatMap - copy and move")
+{
+	TestFlatMap small;
+	small[1].push_back(1);
+	small[2].push_back(2);
+
+	TestFlatMap large;
+	for (uint16_t key = 0; key < 10; key++) large[key].push_back(key * 10);
+
+	TestFlatMap small_copy(small);
+	TestFlatMap large_copy(large);
+	CHECK(small_copy == small);
+	CHECK(large_copy == large);
+
+	TestFlatMap small_moved(std::move(small_copy));
+	TestFlatMap large_moved(std::move(large_copy));
+	CHECK(small_copy.empty());
+	CHECK(large_copy.empty());
+	CHECK(small_moved == small);
+	CHECK(large_moved == large);
+
+	small_moved = large;
+	CHECK(small_moved == large);
+	large_moved = std::move(small);
+	CHECK(MatchesKeys(large_moved, { 1, 2 }));
+	CHECK(large_moved.capacity() == 4);
+}
+
+template <typename T>
+static std::vector<uint32_t> CollectMultiMap(const T &map)
+{
+	std::vector<uint32_t> result;
+	for (typename T::const_iterator it(map.begin()); it != map.end(); ++it) {
+		result.push_back(*it);
+	}
+	return result;
+}
+
+TEST_CASE("FlatMap - MultiMap")
+{
+	using FlatMultiMap = MultiMap<uint16_t, uint32_t, ring_buffer<uint32_t>, std::less<uint16_t>, flat_map<uint16_t, ring_buffer<uint32_t>, 4>>;
+	using StdMultiMap = MultiMap<uint16_t, uint32_t, ring_buffer<uint32_t>>;
+
+	FlatMultiMap flat;
+	StdMultiMap std_map;
+	for (uint32_t i = 0; i < 64; i++) {
+		uint16_t key = (i * 7) % 6;
+		flat.Insert(key, i);
+		std_map.Insert(key, i);
+	}
+	CHECK(flat.size() == 64);
+	CHECK(flat.MapSize() == 6);
+	CHECK(CollectMultiMap(flat) == CollectMultiMap(std_map));
+
+	/* Erase every third item through the MultiMap iterator. */
+	uint n = 0;
+	for (FlatMultiMap::iterator it(flat.begin()); it != flat.end(); n++) {
+		if (n % 3 == 0) {
+			it = flat.erase(it);
+		} else {
+			++it;
+		}
+	}
+	n = 0;
+	for (StdMultiMap::iterator it(std_map.begin()); it != std_map.end(); n++) {
+		if (n % 3 == 0) {
+			it = std_map.erase(it);
+		} else {
+			++it;
+		}
+	}
+	CHECK(CollectMultiMap(flat) == CollectMultiMap(std_map));
+
+	/* Erasing all items of a key removes that key. */
+	auto range = flat.equal_range(2);
+	for (FlatMultiMap::iterator it = range.first; it != flat.end() && it.GetKey() == 2;) {
+		it = flat.erase(it);
+	}
+	CHECK(flat.find(2) == flat.Map::end());
+	CHECK(flat.MapSize() == 5);
+}
+
+/**
+ * Replay a sequence of station cargo style operations: packets are appended for one of a few next hops,
+ * and loads take packets from the front of the list for one next hop, as StationCargoList::ShiftCargo does.
+ * @return Checksum of the loaded values, to stop the work being optimised away.
+ */
+template <typename T>
+static uint64_t ReplayCargoOperations(T &map, const std::vector<uint32_t> &ops)
+{
+	uint64_t checksum = 0;
+	for (uint32_t op : ops) {
+		uint16_t key = op & 3;
+		if (op & 4) {
+			map.Insert(key, op);
+		} else {
+			for (uint i = 0; i < 4; i++) {
+				auto map_it = map.find(key);
+				if (map_it == map.Map::end()) break;
+				checksum += map_it->second.front();
+				map_it->second.pop_front();
+				if (map_it->second.empty()) map.Map::erase(map_it);
+			}
+		}
+	}
+	return checksum;
+}
+
+TEST_CASE("FlatMap - cargo operation benchmark", "[.][bench]")
+{
+	using FlatMultiMap = MultiMap<uint16_t, uint32_t, ring_buffer<uint32_t>, std::less<uint16_t>, flat_map<uint16_t, ring_buffer<uint32_t>, 4>>;
+	using StdMultiMap = MultiMap<uint16_t, uint32_t, ring_buffer<uint32_t>>;
+
+	std::vector<uint32_t> ops;
+	uint32_t seed = 12345;
+	for (uint i = 0; i < 4000000; i++) {
+		seed = seed * 1103515245 + 12345;
+		ops.push_back(seed >> 8);
+	}
+
+	auto run = [&](auto &map, const char *name) -> uint64_t {
+		auto start = std::chrono::steady_clock::now();
+		uint64_t checksum = ReplayCargoOperations(map, ops);
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		WARN(name << ": " << ops.size() << " operations in " << duration.count() << " us, " << (ops.size() / std::max<int64_t>(1, duration.count())) << " ops/us");
+		return checksum;
+	};
+
+	FlatMultiMap flat;
+	StdMultiMap std_map;
+	uint64_t flat_checksum = run(flat, "flat_map");
+	uint64_t std_checksum = run(std_map, "std::map");
+	CHECK(flat_checksum == std_checksum);
+}
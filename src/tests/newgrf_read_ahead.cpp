@@ -0,0 +1,180 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file newgrf_read_ahead.cpp Test the cache of the NewGRF read ahead records. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../newgrf_internal.h"
+#include "../fileio_func.h"
+#include "../rev.h"
+
+#include "../safeguards.h"
+
+static const std::string GRF_FILENAME = "newgrf_read_ahead_test.grf";
+static const std::string CACHE_FILENAME = "newgrf_read_ahead_test.dat";
+
+/** Offset of the version in the cache file, after the magic. */
+static const size_t CACHE_VERSION_OFFSET = 4;
+
+/**
+ * Offset of the NewGRF file size in the cache file, after the magic, version, revision and MD5 checksum.
+ * @return The offset.
+ */
+static size_t GetCacheFileSizeOffset()
+{
+	return 8 + strlen(_openttd_revision) + 1 + MD5_HASH_BYTES;
+}
+
+/** A small container version 1 NewGRF with two pseudo sprites, and the cache of its records. */
+struct NewGRFReadAheadFixture {
+	std::vector<Searchpath> searchpaths; ///< The search paths before the test, as the test only looks in the working directory.
+
+	NewGRFReadAheadFixture() : searchpaths(_valid_searchpaths)
+	{
+		_valid_searchpaths = { SP_WORKING_DIR };
+		const byte grf[] = {
+			0x04, 0x00, 0xFF, 0x02, 0x00, 0x00, 0x00, // Sprite count.
+			0x03, 0x00, 0xFF, 0x08, 0x07, 0x00,       // Pseudo sprite.
+			0x02, 0x00, 0xFF, 0x0E, 0x00,             // Pseudo sprite.
+			0x00, 0x00,                               // End of sprites.
+		};
+		REQUIRE(FioReplaceFile(GRF_FILENAME, grf, sizeof(grf)));
+		unlink(CACHE_FILENAME.c_str());
+	}
+
+	~NewGRFReadAheadFixture()
+	{
+		unlink(GRF_FILENAME.c_str());
+		unlink(CACHE_FILENAME.c_str());
+		_valid_searchpaths = this->searchpaths;
+	}
+
+	/**
+	 * Read the records of the NewGRF, using the cache.
+	 * @return The read records.
+	 */
+	NewGRFReadAheadFile Read() const
+	{
+		NewGRFReadAheadFile file;
+		file.filename = GRF_FILENAME;
+		file.subdir = NO_DIRECTORY;
+		file.needs_palette_remap = false;
+		file.md5sum.fill(0x5A);
+		file.cache_filename = CACHE_FILENAME;
+		file.Read();
+		return file;
+	}
+
+	/**
+	 * Get the size of the cache file.
+	 * @return The size.
+	 */
+	size_t GetCacheSize() const
+	{
+		size_t size;
+		std::unique_ptr<char[]> data = ReadFileToMem(CACHE_FILENAME, size, SIZE_MAX);
+		REQUIRE(data != nullptr);
+		return size;
+	}
+
+	/**
+	 * Change the content of the cache file.
+	 * @param offset Offset of the value to change.
+	 * @param value New value, as a little endian 32 bit number.
+	 */
+	void PatchCache(size_t offset, uint32_t value) const
+	{
+		size_t size;
+		std::unique_ptr<char[]> data = ReadFileToMem(CACHE_FILENAME, size, SIZE_MAX);
+		REQUIRE(data != nullptr);
+		REQUIRE(offset + 4 <= size);
+		for (uint i = 0; i < 4; i++) data[offset + i] = GB(value, i * 8, 8);
+		REQUIRE(FioReplaceFile(CACHE_FILENAME, data.get(), size));
+	}
+
+	/**
+	 * Check that the records of the test NewGRF were read.
+	 * @param file The read records.
+	 */
+	static void CheckRecords(const NewGRFReadAheadFile &file)
+	{
+		REQUIRE(file.valid);
+		CHECK(file.start_pos == 7);
+		CHECK(file.end_pos == 18);
+		REQUIRE(file.sprites.size() == 2);
+		CHECK(file.sprites[0].start_pos == 7);
+		CHECK(file.sprites[0].num == 3);
+		CHECK(file.sprites[1].start_pos == 13);
+		CHECK(file.sprites[1].num == 2);
+		CHECK(file.data == std::vector<byte>{ 0x08, 0x07, 0x00, 0x0E, 0x00 });
+	}
+};
+
+TEST_CASE("NewGRFReadAheadFile - cache round trip")
+{
+	NewGRFReadAheadFixture fixture;
+
+	NewGRFReadAheadFile parsed = fixture.Read();
+	CHECK_FALSE(parsed.from_cache);
+	NewGRFReadAheadFixture::CheckRecords(parsed);
+
+	NewGRFReadAheadFile cached = fixture.Read();
+	CHECK(cached.from_cache);
+	NewGRFReadAheadFixture::CheckRecords(cached);
+}
+
+TEST_CASE("NewGRFReadAheadFile - mismatched cache falls back to parsing")
+{
+	NewGRFReadAheadFixture fixture;
+	fixture.Read();
+
+	SECTION("version") {
+		fixture.PatchCache(CACHE_VERSION_OFFSET, 0xFFFF);
+	}
+
+	SECTION("NewGRF file size") {
+		fixture.PatchCache(GetCacheFileSizeOffset(), 19);
+	}
+
+	SECTION("record offset") {
+		/* The position of the first record follows the file size and the checksum of the records. */
+		fixture.PatchCache(GetCacheFileSizeOffset() + 8 + MD5_HASH_BYTES, 8);
+	}
+
+	SECTION("pseudo sprite data") {
+		/* The data of the pseudo sprites is at the end; changing it is only caught by the checksum of the records. */
+		fixture.PatchCache(fixture.GetCacheSize() - 4, 0x00FF0000);
+	}
+
+	NewGRFReadAheadFile file = fixture.Read();
+	CHECK_FALSE(file.from_cache);
+	NewGRFReadAheadFixture::CheckRecords(file);
+
+	/* The cache was written again. */
+	CHECK(fixture.Read().from_cache);
+}
+
+TEST_CASE("NewGRFReadAheadFile - changed NewGRF size falls back to parsing")
+{
+	NewGRFReadAheadFixture fixture;
+	fixture.Read();
+
+	/* Data after the end of sprites marker does not change the records, only the size. */
+	size_t size;
+	std::unique_ptr<char[]> data = ReadFileToMem(GRF_FILENAME, size, SIZE_MAX);
+	REQUIRE(data != nullptr);
+	std::vector<char> grf(data.get(), data.get() + size);
+	grf.push_back(0);
+	REQUIRE(FioReplaceFile(GRF_FILENAME, grf.data(), grf.size()));
+
+	NewGRFReadAheadFile file = fixture.Read();
+	CHECK_FALSE(file.from_cache);
+	NewGRFReadAheadFixture::CheckRecords(file);
+}
@@ -0,0 +1,55 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file serialisation.cpp Test functionality from core/serialisation.hpp */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../core/serialisation.hpp"
+
+TEST_CASE("BufferSerialiser/BufferDeserialiser - round trip")
+{
+	std::vector<byte> buffer;
+	BufferSerialiser writer(buffer);
+	writer.Send_uint8(0x12);
+	writer.Send_uint16(0x3456);
+	writer.Send_uint32(0x789ABCDE);
+	writer.Send_uint64(0x0123456789ABCDEFULL);
+	writer.Send_string("test");
+	const byte binary[] = { 1, 2, 3 };
+	writer.Send_binary(binary, sizeof(binary));
+
+	BufferDeserialiser reader(buffer);
+	CHECK(reader.Recv_uint8() == 0x12);
+	CHECK(reader.Recv_uint16() == 0x3456);
+	CHECK(reader.Recv_uint32() == 0x789ABCDE);
+	CHECK(reader.Recv_uint64() == 0x0123456789ABCDEFULL);
+	CHECK(reader.Recv_string(16) == "test");
+	std::span<const uint8_t> view = reader.Recv_binary_view(sizeof(binary));
+	CHECK(std::equal(view.begin(), view.end(), std::begin(binary), std::end(binary)));
+	CHECK(!reader.error);
+	CHECK(reader.pos == buffer.size());
+}
+
+TEST_CASE("BufferDeserialiser - truncated buffer")
+{
+	std::vector<byte> buffer;
+	BufferSerialiser writer(buffer);
+	writer.Send_uint16(0x1234);
+
+	BufferDeserialiser reader(buffer);
+	CHECK(!reader.CanRecvBytes(4, false));
+	CHECK(!reader.error);
+	CHECK(reader.Recv_uint32() == 0);
+	CHECK(reader.error);
+
+	/* Once an error occurred, nothing more is read. */
+	CHECK(reader.Recv_uint8() == 0);
+	CHECK(reader.pos == 0);
+}
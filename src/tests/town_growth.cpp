@@ -0,0 +1,143 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file town_growth.cpp Test that towns grow alike with the serial and the parallel search for places to grow. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "mock_environment.h"
+
+#include "../clear_map.h"
+#include "../command_func.h"
+#include "../company_func.h"
+#include "../core/backup_type.hpp"
+#include "../core/pool_type.hpp"
+#include "../core/random_func.hpp"
+#include "../date_func.h"
+#include "../openttd.h"
+#include "../road.h"
+#include "../road_map.h"
+#include "../settings_internal.h"
+#include "../sl/saveload.h"
+#include "../town.h"
+#include "../town_kdtree.h"
+#include "../void_map.h"
+
+#include "../safeguards.h"
+
+extern void InitializeBuildingCounts();
+extern void OnTick_Town();
+
+/** Growth of the towns of a world after a number of ticks. */
+struct TownGrowthStatistics {
+	uint houses = 0; ///< Number of house tiles.
+	uint roads = 0;  ///< Number of road tiles.
+};
+
+/** Set all game settings to their default values. */
+static void ResetGameSettingsToDefault()
+{
+	IterateSettingsTables([](const SettingTable &table, void *object) {
+		if (object != &_settings_game) return;
+		for (auto &sd : table) {
+			if (!SlIsObjectCurrentlyValid(sd->save.version_from, sd->save.version_to, sd->save.ext_feature_test)) continue;
+			sd->ParseValue(nullptr, object);
+		}
+	});
+}
+
+/**
+ * Found four towns on a flat map, and let them grow in every tick.
+ * The growth rate is fixed like a game script would, so building houses does not slow the towns down.
+ * @param seed Seed of the game's random stream.
+ * @param frontier Whether towns first try to grow where they recently grew.
+ * @param parallel Whether to search for places to grow in parallel.
+ * @param ticks Number of ticks to grow the towns for.
+ * @return The tiles of the towns after growing.
+ */
+static TownGrowthStatistics GrowTowns(uint32_t seed, bool frontier, bool parallel, uint ticks)
+{
+	MockEnvironment::Instance();
+
+	ResetGameSettingsToDefault();
+	_settings_game.economy.town_growth_frontier = frontier;
+	_settings_game.economy.town_growth_parallel = parallel;
+	ResetHouses();
+	ResetRoadTypes();
+	InitRoadTypes();
+
+	AllocateMap(128, 128);
+	for (TileIndex tile = 0; tile < MapSize(); tile++) {
+		if (TileX(tile) == 0 || TileY(tile) == 0 || TileX(tile) == MapMaxX() || TileY(tile) == MapMaxY()) {
+			MakeVoid(tile);
+		} else {
+			MakeClear(tile, CLEAR_GRASS, 3);
+		}
+	}
+	InitializeBuildingCounts();
+	CalTime::Detail::SetDate(CalTime::ConvertYMDToDate(1990, 0, 1), 0);
+	EconTime::Detail::SetDate(EconTime::ConvertYMDToDate(1990, 0, 1), 0);
+
+	_random.SetSeed(seed);
+
+	Backup<GameMode> game_mode(_game_mode, GM_EDITOR, FILE_LINE);
+	Backup<CompanyID> cur_company(_current_company, OWNER_DEITY, FILE_LINE);
+	for (uint i = 0; i < 4; i++) {
+		std::string name = "Town " + std::to_string(i);
+		CommandCost ret = DoCommand(TileXY(32 + 64 * (i % 2), 32 + 64 * (i / 2)), TSZ_SMALL | (TL_ORIGINAL << 3), 0, DC_EXEC, CMD_FOUND_TOWN, name.c_str());
+		REQUIRE(ret.Succeeded());
+	}
+	cur_company.Restore();
+	game_mode.Change(GM_NORMAL);
+
+	for (Town *t : Town::Iterate()) {
+		SetBit(t->flags, TOWN_IS_GROWING);
+		SetBit(t->flags, TOWN_CUSTOM_GROWTH);
+		t->growth_rate = 0;
+		t->grow_counter = 0;
+	}
+	for (uint i = 0; i < ticks; i++) OnTick_Town();
+	game_mode.Restore();
+
+	TownGrowthStatistics statistics;
+	for (TileIndex tile = 0; tile < MapSize(); tile++) {
+		if (IsTileType(tile, MP_HOUSE)) statistics.houses++;
+		if (IsNormalRoadTile(tile) && IsRoadOwner(tile, RTT_ROAD, OWNER_TOWN)) statistics.roads++;
+	}
+
+	_town_kdtree.Clear();
+	PoolBase::Clean(PT_NORMAL);
+	return statistics;
+}
+
+TEST_CASE("Town growth - parallel search grows towns like the serial search")
+{
+	/* The modes draw different random numbers, so compare the average over a number of worlds. */
+	static const uint WORLDS = 32;
+	static const uint TICKS = 400;
+
+	bool frontier = GENERATE(false, true);
+	INFO("frontier: " << frontier);
+
+	double serial_houses = 0, serial_roads = 0, parallel_houses = 0, parallel_roads = 0;
+	for (uint i = 0; i < WORLDS; i++) {
+		const uint32_t seed = 0x1234567 + i * 0x9E3779B9;
+		TownGrowthStatistics serial = GrowTowns(seed, frontier, false, TICKS);
+		TownGrowthStatistics parallel = GrowTowns(seed, frontier, true, TICKS);
+		serial_houses += serial.houses;
+		serial_roads += serial.roads;
+		parallel_houses += parallel.houses;
+		parallel_roads += parallel.roads;
+	}
+
+	INFO("houses: serial " << serial_houses / WORLDS << ", parallel " << parallel_houses / WORLDS);
+	INFO("roads: serial " << serial_roads / WORLDS << ", parallel " << parallel_roads / WORLDS);
+	CHECK(parallel_houses == Approx(serial_houses).epsilon(0.05));
+	CHECK(parallel_roads == Approx(serial_roads).epsilon(0.05));
+}
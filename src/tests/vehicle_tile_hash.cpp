@@ -0,0 +1,132 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file vehicle_tile_hash.cpp Test the vehicle tile hash position queries. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../train.h"
+#include "../vehicle_func.h"
+
+#include <chrono>
+#include <vector>
+
+/** Dense grid of train vehicles, placed into the vehicle tile hash. */
+struct VehicleTileHashFixture {
+	std::vector<Train *> trains;
+
+	VehicleTileHashFixture()
+	{
+		AllocateMap(256, 256);
+
+		uint32_t seed = 12345;
+		for (uint ty = 1; ty < 128; ty++) {
+			for (uint tx = 1; tx < 128; tx++) {
+				/* Two vehicles on most tiles, as on a busy double track network. */
+				for (uint i = 0; i < 2; i++) {
+					seed = seed * 1103515245 + 12345;
+					if ((seed >> 28) == 0) continue;
+					REQUIRE(Train::CanAllocateItem());
+					Train *t = new Train();
+					t->x_pos = tx * TILE_SIZE + GB(seed, 8, 4);
+					t->y_pos = ty * TILE_SIZE + GB(seed, 12, 4);
+					t->tile = TileVirtXY(t->x_pos, t->y_pos);
+					t->UpdatePosition();
+					this->trains.push_back(t);
+				}
+			}
+		}
+	}
+
+	~VehicleTileHashFixture()
+	{
+		ResetVehicleHash();
+		_vehicle_pool.CleanPool();
+	}
+};
+
+/** Data for the callback version of the collision style query. */
+struct NearbyVehicleChecker {
+	const Vehicle *v;
+	uint num;
+};
+
+static bool IsNearbyVehicle(const Vehicle *v, const Vehicle *u)
+{
+	if (v == u) return false;
+	int x_diff = v->x_pos - u->x_pos;
+	int y_diff = v->y_pos - u->y_pos;
+	return x_diff * x_diff + y_diff * y_diff < 25;
+}
+
+static Vehicle *CountNearbyVehicleEnum(Vehicle *v, void *data)
+{
+	NearbyVehicleChecker *checker = static_cast<NearbyVehicleChecker *>(data);
+	if (IsNearbyVehicle(v, checker->v)) checker->num++;
+	return nullptr;
+}
+
+static uint CountNearbyCallback(const Train *t)
+{
+	NearbyVehicleChecker checker{ t, 0 };
+	FindVehicleOnPosXY(t->x_pos, t->y_pos, VEH_TRAIN, &checker, &CountNearbyVehicleEnum);
+	return checker.num;
+}
+
+static uint CountNearbyLambda(const Train *t)
+{
+	uint num = 0;
+	FindVehicleOnPosXY(t->x_pos, t->y_pos, VEH_TRAIN, [&](const Vehicle *v) {
+		if (IsNearbyVehicle(v, t)) num++;
+	});
+	return num;
+}
+
+TEST_CASE("VehicleTileHash - position queries")
+{
+	VehicleTileHashFixture fixture;
+
+	uint total = 0;
+	for (const Train *t : fixture.trains) {
+		uint num = CountNearbyLambda(t);
+		CHECK(num == CountNearbyCallback(t));
+		total += num;
+
+		uint on_tile = 0;
+		FindVehicleOnPos(t->tile, VEH_TRAIN, [&](const Vehicle *) { on_tile++; });
+		CHECK(on_tile > 0);
+		CHECK(HasAnyVehicleOnPos(t->tile, VEH_TRAIN));
+		CHECK(HasVehicleOnPos(t->tile, VEH_TRAIN, [&](const Vehicle *v) { return v == t; }));
+		CHECK(HasVehicleOnPosXY(t->x_pos, t->y_pos, VEH_TRAIN, [&](const Vehicle *v) { return v == t; }));
+	}
+	CHECK(total > 0);
+
+	CHECK_FALSE(HasAnyVehicleOnPos(TileXY(200, 200), VEH_TRAIN));
+	CHECK_FALSE(HasAnyVehicleOnPos(fixture.trains.front()->tile, VEH_ROAD));
+}
+
+TEST_CASE("VehicleTileHash - collision check benchmark", "[.][bench]")
+{
+	VehicleTileHashFixture fixture;
+
+	auto run = [&](auto count_nearby, const char *name) -> uint {
+		auto start = std::chrono::steady_clock::now();
+		uint total = 0;
+		for (uint i = 0; i < 50; i++) {
+			for (const Train *t : fixture.trains) total += count_nearby(t);
+		}
+		auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		WARN(name << ": " << fixture.trains.size() * 50 << " collision checks in " << duration.count() << " us");
+		return total;
+	};
+
+	uint callback_total = run(CountNearbyCallback, "callback");
+	uint lambda_total = run(CountNearbyLambda, "lambda");
+	CHECK(callback_total == lambda_total);
+}
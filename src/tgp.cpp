@@ -14,6 +14,10 @@
 #include "genworld.h"
 #include "core/random_func.hpp"
 #include "landscape_type.h"
+#include "worker_thread.h"
+#include "debug.h"
+
+#include <chrono>
 
 #include "safeguards.h"
 
@@ -340,6 +344,37 @@ static inline void FreeHeightMap()
 	_height_map.h.clear();
 }
 
+/**
+ * Run a function over blocks of height map rows (or items of similar size), using the worker thread pool.
+ * Blocks are processed concurrently and in no particular order, so the function must only modify
+ * height map data belonging to the items of its block, and must not use the game random number generator.
+ * @param count Number of items.
+ * @param func Function taking the first and the last (exclusive) item of a block.
+ */
+template <typename F>
+static void HeightMapParallelFor(int count, F func)
+{
+	const int block_size = 64;
+	if (count <= 0) return;
+	_general_worker_pool.ParallelFor((count + block_size - 1) / block_size, [&](uint block) {
+		const int first = block * block_size;
+		func(first, std::min(count, first + block_size));
+	});
+}
+
+/**
+ * Run a height map generation pass, and report how long it took.
+ * @param name Name of the pass.
+ * @param pass Function performing the pass.
+ */
+template <typename F>
+static void HeightMapRunPass(const char *name, F pass)
+{
+	auto start = std::chrono::steady_clock::now();
+	pass();
+	DEBUG(map, 2, "TGP: %s took %ums", name, (uint)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
 /**
  * Generates new random height in given amplitude (generated numbers will range from - amplitude to + amplitude)
  * @param rMax Limit of result
@@ -388,27 +423,34 @@ static void HeightMapGenerate()
 		}
 
 		/* It is regular iteration round.
-		 * Interpolate height values at odd x, even y tiles */
-		for (int y = 0; y <= _height_map.size_y; y += 2 * step) {
-			for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
-				Height h00 = _height_map.height(x + 0 * step, y);
-				Height h02 = _height_map.height(x + 2 * step, y);
-				Height h01 = (h00 + h02) / 2;
-				_height_map.height(x + 1 * step, y) = h01;
+		 * Interpolate height values at odd x, even y tiles.
+		 * Each row only reads and writes itself, so the rows can be done in parallel. */
+		HeightMapParallelFor(_height_map.size_y / (2 * step) + 1, [&](int first, int last) {
+			for (int y = first * 2 * step; y < last * 2 * step; y += 2 * step) {
+				for (int x = 0; x <= _height_map.size_x - 2 * step; x += 2 * step) {
+					Height h00 = _height_map.height(x + 0 * step, y);
+					Height h02 = _height_map.height(x + 2 * step, y);
+					Height h01 = (h00 + h02) / 2;
+					_height_map.height(x + 1 * step, y) = h01;
+				}
 			}
-		}
+		});
 
-		/* Interpolate height values at odd y tiles */
-		for (int y = 0; y <= _height_map.size_y - 2 * step; y += 2 * step) {
-			for (int x = 0; x <= _height_map.size_x; x += step) {
-				Height h00 = _height_map.height(x, y + 0 * step);
-				Height h20 = _height_map.height(x, y + 2 * step);
-				Height h10 = (h00 + h20) / 2;
-				_height_map.height(x, y + 1 * step) = h10;
+		/* Interpolate height values at odd y tiles.
+		 * Each odd row only reads the even rows either side of it. */
+		HeightMapParallelFor((_height_map.size_y - 2 * step) / (2 * step) + 1, [&](int first, int last) {
+			for (int y = first * 2 * step; y < last * 2 * step; y += 2 * step) {
+				for (int x = 0; x <= _height_map.size_x; x += step) {
+					Height h00 = _height_map.height(x, y + 0 * step);
+					Height h20 = _height_map.height(x, y + 2 * step);
+					Height h10 = (h00 + h20) / 2;
+					_height_map.height(x, y + 1 * step) = h10;
+				}
 			}
-		}
+		});
 
-		/* Add noise for next higher frequency (smaller steps) */
+		/* Add noise for next higher frequency (smaller steps).
+		 * This uses the game random number generator, so must remain serial to keep maps identical for the same seed. */
 		for (int y = 0; y <= _height_map.size_y; y += step) {
 			for (int x = 0; x <= _height_map.size_x; x += step) {
 				_height_map.height(x, y) += RandomHeight(amplitude);
@@ -454,79 +496,87 @@ static int *HeightMapMakeHistogram(Height h_min, [[maybe_unused]] Height h_max,
 	return hist;
 }
 
-/** Applies sine wave redistribution onto height map */
-static void HeightMapSineTransform(Height h_min, Height h_max)
+/** Applies sine wave redistribution onto a single height of the height map */
+static inline void HeightMapSineTransformHeight(Height &h, Height h_min, Height h_max)
 {
-	for (Height &h : _height_map.h) {
-		double fheight;
-
-		if (h < h_min) continue;
-
-		/* Transform height into 0..1 space */
-		fheight = (double)(h - h_min) / (double)(h_max - h_min);
-		/* Apply sine transform depending on landscape type */
-		switch (_settings_game.game_creation.landscape) {
-			case LT_TOYLAND:
-			case LT_TEMPERATE:
-				/* Move and scale 0..1 into -1..+1 */
-				fheight = 2 * fheight - 1;
-				/* Sine transform */
-				fheight = sin(fheight * M_PI_2);
-				/* Transform it back from -1..1 into 0..1 space */
-				fheight = 0.5 * (fheight + 1);
-				break;
-
-			case LT_ARCTIC:
-				{
-					/* Arctic terrain needs special height distribution.
-					 * Redistribute heights to have more tiles at highest (75%..100%) range */
-					double sine_upper_limit = 0.75;
-					double linear_compression = 2;
-					if (fheight >= sine_upper_limit) {
-						/* Over the limit we do linear compression up */
-						fheight = 1.0 - (1.0 - fheight) / linear_compression;
-					} else {
-						double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
-						/* Get 0..sine_upper_limit into -1..1 */
-						fheight = 2.0 * fheight / sine_upper_limit - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
-						fheight = 0.5 * (fheight + 1.0) * m;
-					}
+	double fheight;
+
+	if (h < h_min) return;
+
+	/* Transform height into 0..1 space */
+	fheight = (double)(h - h_min) / (double)(h_max - h_min);
+	/* Apply sine transform depending on landscape type */
+	switch (_settings_game.game_creation.landscape) {
+		case LT_TOYLAND:
+		case LT_TEMPERATE:
+			/* Move and scale 0..1 into -1..+1 */
+			fheight = 2 * fheight - 1;
+			/* Sine transform */
+			fheight = sin(fheight * M_PI_2);
+			/* Transform it back from -1..1 into 0..1 space */
+			fheight = 0.5 * (fheight + 1);
+			break;
+
+		case LT_ARCTIC:
+			{
+				/* Arctic terrain needs special height distribution.
+				 * Redistribute heights to have more tiles at highest (75%..100%) range */
+				double sine_upper_limit = 0.75;
+				double linear_compression = 2;
+				if (fheight >= sine_upper_limit) {
+					/* Over the limit we do linear compression up */
+					fheight = 1.0 - (1.0 - fheight) / linear_compression;
+				} else {
+					double m = 1.0 - (1.0 - sine_upper_limit) / linear_compression;
+					/* Get 0..sine_upper_limit into -1..1 */
+					fheight = 2.0 * fheight / sine_upper_limit - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to 0..(1 - (1 - sine_upper_limit) / linear_compression) == 0.0..m */
+					fheight = 0.5 * (fheight + 1.0) * m;
 				}
-				break;
-
-			case LT_TROPIC:
-				{
-					/* Desert terrain needs special height distribution.
-					 * Half of tiles should be at lowest (0..25%) heights */
-					double sine_lower_limit = 0.5;
-					double linear_compression = 2;
-					if (fheight <= sine_lower_limit) {
-						/* Under the limit we do linear compression down */
-						fheight = fheight / linear_compression;
-					} else {
-						double m = sine_lower_limit / linear_compression;
-						/* Get sine_lower_limit..1 into -1..1 */
-						fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
-						/* Sine wave transform */
-						fheight = sin(fheight * M_PI_2);
-						/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
-						fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
-					}
+			}
+			break;
+
+		case LT_TROPIC:
+			{
+				/* Desert terrain needs special height distribution.
+				 * Half of tiles should be at lowest (0..25%) heights */
+				double sine_lower_limit = 0.5;
+				double linear_compression = 2;
+				if (fheight <= sine_lower_limit) {
+					/* Under the limit we do linear compression down */
+					fheight = fheight / linear_compression;
+				} else {
+					double m = sine_lower_limit / linear_compression;
+					/* Get sine_lower_limit..1 into -1..1 */
+					fheight = 2.0 * ((fheight - sine_lower_limit) / (1.0 - sine_lower_limit)) - 1.0;
+					/* Sine wave transform */
+					fheight = sin(fheight * M_PI_2);
+					/* Get -1..1 back to (sine_lower_limit / linear_compression)..1.0 */
+					fheight = 0.5 * ((1.0 - m) * fheight + (1.0 + m));
 				}
-				break;
+			}
+			break;
 
-			default:
-				NOT_REACHED();
-				break;
-		}
-		/* Transform it back into h_min..h_max space */
-		h = (Height)(fheight * (h_max - h_min) + h_min);
-		if (h < 0) h = I2H(0);
-		if (h >= h_max) h = h_max - 1;
+		default:
+			NOT_REACHED();
+			break;
 	}
+	/* Transform it back into h_min..h_max space */
+	h = (Height)(fheight * (h_max - h_min) + h_min);
+	if (h < 0) h = I2H(0);
+	if (h >= h_max) h = h_max - 1;
+}
+
+/** Applies sine wave redistribution onto height map */
+static void HeightMapSineTransform(Height h_min, Height h_max)
+{
+	HeightMapParallelFor(_height_map.size_y + 1, [&](int first, int last) {
+		for (Height *it = _height_map.h.data() + static_cast<size_t>(first) * _height_map.dim_x; it != _height_map.h.data() + static_cast<size_t>(last) * _height_map.dim_x; it++) {
+			HeightMapSineTransformHeight(*it, h_min, h_max);
+		}
+	});
 }
 
 /**
@@ -574,9 +624,6 @@ static void HeightMapCurves(uint level)
 		{ lengthof(curve_map_4), curve_map_4 },
 	};
 
-	Height ht[lengthof(curve_maps)];
-	MemSetT(ht, 0, lengthof(ht));
-
 	/* Set up a grid to choose curve maps based on location; attempt to get a somewhat square grid */
 	float factor = sqrt((float)_height_map.size_x / (float)_height_map.size_y);
 	uint sx = Clamp((int)(((1 << level) * factor) + 0.5), 1, 128);
@@ -587,90 +634,95 @@ static void HeightMapCurves(uint level)
 		c[i] = Random() % lengthof(curve_maps);
 	}
 
-	/* Apply curves */
-	for (int x = 0; x < _height_map.size_x; x++) {
-
-		/* Get our X grid positions and bi-linear ratio */
-		float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
-		uint x1 = (uint)fx;
-		uint x2 = x1;
-		float xr = 2.0f * (fx - x1) - 1.0f;
-		xr = sin(xr * M_PI_2);
-		xr = sin(xr * M_PI_2);
-		xr = 0.5f * (xr + 1.0f);
-		float xri = 1.0f - xr;
-
-		if (x1 > 0) {
-			x1--;
-			if (x2 >= sx) x2--;
-		}
-
-		for (int y = 0; y < _height_map.size_y; y++) {
-
-			/* Get our Y grid position and bi-linear ratio */
-			float fy = (float)(sy * y) / _height_map.size_y + 1.0f;
-			uint y1 = (uint)fy;
-			uint y2 = y1;
-			float yr = 2.0f * (fy - y1) - 1.0f;
-			yr = sin(yr * M_PI_2);
-			yr = sin(yr * M_PI_2);
-			yr = 0.5f * (yr + 1.0f);
-			float yri = 1.0f - yr;
-
-			if (y1 > 0) {
-				y1--;
-				if (y2 >= sy) y2--;
+	/* Apply curves, each column is independent of the others */
+	HeightMapParallelFor(_height_map.size_x, [&](int first, int last) {
+		Height ht[lengthof(curve_maps)];
+		MemSetT(ht, 0, lengthof(ht));
+
+		for (int x = first; x < last; x++) {
+
+			/* Get our X grid positions and bi-linear ratio */
+			float fx = (float)(sx * x) / _height_map.size_x + 1.0f;
+			uint x1 = (uint)fx;
+			uint x2 = x1;
+			float xr = 2.0f * (fx - x1) - 1.0f;
+			xr = sin(xr * M_PI_2);
+			xr = sin(xr * M_PI_2);
+			xr = 0.5f * (xr + 1.0f);
+			float xri = 1.0f - xr;
+
+			if (x1 > 0) {
+				x1--;
+				if (x2 >= sx) x2--;
 			}
 
-			uint corner_a = c[x1 + sx * y1];
-			uint corner_b = c[x1 + sx * y2];
-			uint corner_c = c[x2 + sx * y1];
-			uint corner_d = c[x2 + sx * y2];
+			for (int y = 0; y < _height_map.size_y; y++) {
+
+				/* Get our Y grid position and bi-linear ratio */
+				float fy = (float)(sy * y) / _height_map.size_y + 1.0f;
+				uint y1 = (uint)fy;
+				uint y2 = y1;
+				float yr = 2.0f * (fy - y1) - 1.0f;
+				yr = sin(yr * M_PI_2);
+				yr = sin(yr * M_PI_2);
+				yr = 0.5f * (yr + 1.0f);
+				float yri = 1.0f - yr;
+
+				if (y1 > 0) {
+					y1--;
+					if (y2 >= sy) y2--;
+				}
+
+				uint corner_a = c[x1 + sx * y1];
+				uint corner_b = c[x1 + sx * y2];
+				uint corner_c = c[x2 + sx * y1];
+				uint corner_d = c[x2 + sx * y2];
 
-			/* Bitmask of which curve maps are chosen, so that we do not bother
-			 * calculating a curve which won't be used. */
-			uint corner_bits = 0;
-			corner_bits |= 1 << corner_a;
-			corner_bits |= 1 << corner_b;
-			corner_bits |= 1 << corner_c;
-			corner_bits |= 1 << corner_d;
+				/* Bitmask of which curve maps are chosen, so that we do not bother
+				 * calculating a curve which won't be used. */
+				uint corner_bits = 0;
+				corner_bits |= 1 << corner_a;
+				corner_bits |= 1 << corner_b;
+				corner_bits |= 1 << corner_c;
+				corner_bits |= 1 << corner_d;
 
-			Height *h = &_height_map.height(x, y);
+				Height *h = &_height_map.height(x, y);
 
-			/* Do not touch sea level */
-			if (*h < I2H(1)) continue;
+				/* Do not touch sea level */
+				if (*h < I2H(1)) continue;
 
-			/* Only scale above sea level */
-			*h -= I2H(1);
+				/* Only scale above sea level */
+				*h -= I2H(1);
 
-			/* Apply all curve maps that are used on this tile. */
-			for (uint t = 0; t < lengthof(curve_maps); t++) {
-				if (!HasBit(corner_bits, t)) continue;
+				/* Apply all curve maps that are used on this tile. */
+				for (uint t = 0; t < lengthof(curve_maps); t++) {
+					if (!HasBit(corner_bits, t)) continue;
 
-				[[maybe_unused]] bool found = false;
-				const ControlPoint *cm = curve_maps[t].list;
-				for (uint i = 0; i < curve_maps[t].length - 1; i++) {
-					const ControlPoint &p1 = cm[i];
-					const ControlPoint &p2 = cm[i + 1];
+					[[maybe_unused]] bool found = false;
+					const ControlPoint *cm = curve_maps[t].list;
+					for (uint i = 0; i < curve_maps[t].length - 1; i++) {
+						const ControlPoint &p1 = cm[i];
+						const ControlPoint &p2 = cm[i + 1];
 
-					if (*h >= p1.x && *h < p2.x) {
-						ht[t] = p1.y + (*h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
+						if (*h >= p1.x && *h < p2.x) {
+							ht[t] = p1.y + (*h - p1.x) * (p2.y - p1.y) / (p2.x - p1.x);
 #ifdef WITH_FULL_ASSERTS
-						found = true;
+							found = true;
 #endif
-						break;
+							break;
+						}
 					}
+					dbg_assert(found);
 				}
-				dbg_assert(found);
-			}
 
-			/* Apply interpolation of curve map results. */
-			*h = (Height)((ht[corner_a] * yri + ht[corner_b] * yr) * xri + (ht[corner_c] * yri + ht[corner_d] * yr) * xr);
+				/* Apply interpolation of curve map results. */
+				*h = (Height)((ht[corner_a] * yri + ht[corner_b] * yr) * xri + (ht[corner_c] * yri + ht[corner_d] * yr) * xr);
 
-			/* Readd sea level */
-			*h += I2H(1);
+				/* Readd sea level */
+				*h += I2H(1);
+			}
 		}
-	}
+	});
 }
 
 /** Adjusts heights in height map to contain required amount of water tiles */
@@ -702,13 +754,15 @@ static void HeightMapAdjustWaterLevel(Amplitude water_percent, Height h_max_new)
 	 *   values from range: h_water_level..h_max are transformed into 0..h_max_new
 	 *   where h_max_new is depending on terrain type and map size.
 	 */
-	for (Height &h : _height_map.h) {
-		/* Transform height from range h_water_level..h_max into 0..h_max_new range */
-		h = (Height)(((int)h_max_new) * (h - h_water_level) / (h_max - h_water_level)) + I2H(1);
-		/* Make sure all values are in the proper range (0..h_max_new) */
-		if (h < 0) h = I2H(0);
-		if (h >= h_max_new) h = h_max_new - 1;
-	}
+	HeightMapParallelFor(_height_map.size_y + 1, [&](int first, int last) {
+		for (Height *h = _height_map.h.data() + static_cast<size_t>(first) * _height_map.dim_x; h != _height_map.h.data() + static_cast<size_t>(last) * _height_map.dim_x; h++) {
+			/* Transform height from range h_water_level..h_max into 0..h_max_new range */
+			*h = (Height)(((int)h_max_new) * (*h - h_water_level) / (h_max - h_water_level)) + I2H(1);
+			/* Make sure all values are in the proper range (0..h_max_new) */
+			if (*h < 0) *h = I2H(0);
+			if (*h >= h_max_new) *h = h_max_new - 1;
+		}
+	});
 
 	free(hist_buf);
 }
@@ -880,24 +934,24 @@ static void HeightMapNormalize()
 	const Height h_max_new = TGPGetMaxHeight();
 	const Height roughness = 7 + 3 * _settings_game.game_creation.tgen_smoothness;
 
-	HeightMapAdjustWaterLevel(water_percent, h_max_new);
+	HeightMapRunPass("adjust water level", [&]() { HeightMapAdjustWaterLevel(water_percent, h_max_new); });
 
 	byte water_borders = _settings_game.construction.freeform_edges ? _settings_game.game_creation.water_borders : 0xF;
 	if (water_borders == BORDERS_RANDOM) water_borders = GB(Random(), 0, 4);
 
-	HeightMapCoastLines(water_borders);
-	HeightMapSmoothSlopes(roughness);
+	HeightMapRunPass("coast lines", [&]() { HeightMapCoastLines(water_borders); });
+	HeightMapRunPass("smooth slopes", [&]() { HeightMapSmoothSlopes(roughness); });
 
-	HeightMapSmoothCoasts(water_borders);
-	HeightMapSmoothSlopes(roughness);
+	HeightMapRunPass("smooth coasts", [&]() { HeightMapSmoothCoasts(water_borders); });
+	HeightMapRunPass("smooth slopes", [&]() { HeightMapSmoothSlopes(roughness); });
 
-	HeightMapSineTransform(I2H(1), h_max_new);
+	HeightMapRunPass("sine transform", [&]() { HeightMapSineTransform(I2H(1), h_max_new); });
 
 	if (_settings_game.game_creation.variety > 0) {
-		HeightMapCurves(_settings_game.game_creation.variety);
+		HeightMapRunPass("curves", [&]() { HeightMapCurves(_settings_game.game_creation.variety); });
 	}
 
-	HeightMapSmoothSlopes(I2H(1));
+	HeightMapRunPass("smooth slopes", [&]() { HeightMapSmoothSlopes(I2H(1)); });
 }
 
 /**
@@ -995,7 +1049,7 @@ void GenerateTerrainPerlin()
 	if (!AllocHeightMap()) return;
 	GenerateWorldSetAbortCallback(FreeHeightMap);
 
-	HeightMapGenerate();
+	HeightMapRunPass("generate", HeightMapGenerate);
 
 	IncreaseGeneratingWorldProgress(GWP_LANDSCAPE);
 
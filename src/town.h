@@ -21,6 +21,7 @@
 #include "core/tinystring_type.hpp"
 #include <list>
 #include <memory>
+#include <vector>
 
 template <typename T>
 struct BuildingCounts {
@@ -37,6 +38,7 @@ static const uint TOWN_GROWTH_WINTER = 0xFFFFFFFE;    ///< The town only needs t
 static const uint TOWN_GROWTH_DESERT = 0xFFFFFFFF;    ///< The town needs the cargo for growth when on desert (any amount)
 static const uint16_t TOWN_GROWTH_RATE_NONE = 0xFFFF; ///< Special value for Town::growth_rate to disable town growth.
 static const uint16_t MAX_TOWN_GROWTH_TICKS = 930;    ///< Max amount of original town ticks that still fit into uint16_t, about equal to UINT16_MAX / TOWN_GROWTH_TICKS but slightly less to simplify calculations
+static const uint TOWN_GROWTH_FRONTIER_SIZE = 16;     ///< Maximum number of tiles in Town::growth_frontier.
 
 /** Settings for town council attitudes. */
 enum TownCouncilAttitudes {
@@ -133,6 +135,8 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 
 	std::list<PersistentStorage *> psa_list;
 
+	std::vector<TileIndex> growth_frontier; ///< Road tiles the town recently grew from, oldest first. See #TOWN_GROWTH_FRONTIER_SIZE.
+
 	/**
 	 * Creates a new town.
 	 * @param tile center tile of the town
@@ -218,6 +222,7 @@ uint32_t GetWorldPopulation();
 
 void UpdateAllTownVirtCoords();
 void ClearAllTownCachedNames();
+void ClearTownGrowthFrontiers();
 void ShowTownViewWindow(TownID town);
 void ExpandTown(Town *t);
 
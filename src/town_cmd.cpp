@@ -55,6 +55,7 @@
 #include "zoom_func.h"
 #include "zoning.h"
 #include "scope.h"
+#include "worker_thread.h"
 #include "3rdparty/cpp-btree/btree_map.h"
 
 #include "table/strings.h"
@@ -566,6 +567,14 @@ void ClearAllTownCachedNames()
 	}
 }
 
+/** Forget where all towns recently grew, see #Town::growth_frontier. */
+void ClearTownGrowthFrontiers()
+{
+	for (Town *t : Town::Iterate()) {
+		t->growth_frontier.clear();
+	}
+}
+
 /**
  * Change the town's population as recorded in the town cache, town label, and town directory.
  * @param t The town which has changed.
@@ -997,6 +1006,7 @@ static void ChangeTileOwner_Town(TileIndex, Owner, Owner)
 }
 
 static bool GrowTown(Town *t);
+static void OnTick_TownParallel();
 
 /**
  * Handle the town tick for a single town, by growing the town if desired.
@@ -1023,6 +1033,11 @@ void OnTick_Town()
 {
 	if (_game_mode == GM_EDITOR) return;
 
+	if (_settings_game.economy.town_growth_parallel) {
+		OnTick_TownParallel();
+		return;
+	}
+
 	for (Town *t : Town::Iterate()) {
 		TownTickHandler(t);
 	}
@@ -1630,8 +1645,9 @@ static inline bool TownAllowedToBuildRoads(const Town *t)
  * @param cur_rb The current tiles RoadBits
  * @param target_dir The target road dir
  * @param t1 The current town
+ * @param grow_dir Direction to possibly extend the road or build a house in, which was already drawn at random, or INVALID_DIAGDIR to draw it here.
  */
-static void GrowTownInTile(TileIndex *tile_ptr, RoadBits cur_rb, DiagDirection target_dir, Town *t1)
+static void GrowTownInTile(TileIndex *tile_ptr, RoadBits cur_rb, DiagDirection target_dir, Town *t1, DiagDirection grow_dir = INVALID_DIAGDIR)
 {
 	RoadBits rcmd = ROAD_NONE;  // RoadBits for the road construction command
 	TileIndex tile = *tile_ptr; // The main tile on which we base our growth
@@ -1779,7 +1795,7 @@ static void GrowTownInTile(TileIndex *tile_ptr, RoadBits cur_rb, DiagDirection t
 
 		/* Possibly extend the road in a direction.
 		 * Randomize a direction and if it has a road, bail out. */
-		target_dir = RandomDiagDir();
+		target_dir = IsValidDiagDirection(grow_dir) ? grow_dir : RandomDiagDir();
 		RoadBits target_rb = DiagDirToRoadBits(target_dir);
 		TileIndex house_tile; // position of a possible house
 
@@ -1930,37 +1946,58 @@ static bool CanFollowRoad(const Town *t, TileIndex tile, DiagDirection dir)
 }
 
 /**
- * Try to grow a town at a given road tile.
- * @param t The town to grow.
- * @param tile The road tile to try growing from.
- * @return true if we successfully expanded the town.
+ * Remember a road tile a town grew from, so the next growth can start there.
+ * @param t The town.
+ * @param tile The road tile.
  */
-static bool GrowTownAtRoad(Town *t, TileIndex tile)
+static void AddTownGrowthFrontierTile(Town *t, TileIndex tile)
 {
-	/* Special case.
-	 * @see GrowTownInTile Check the else if
-	 */
-	DiagDirection target_dir = DIAGDIR_END; // The direction in which we want to extend the town
+	if (!_settings_game.economy.town_growth_frontier) return;
 
-	assert(tile < MapSize());
+	std::vector<TileIndex> &frontier = t->growth_frontier;
+	auto it = std::find(frontier.begin(), frontier.end(), tile);
+	if (it != frontier.end()) {
+		frontier.erase(it);
+	} else if (frontier.size() >= TOWN_GROWTH_FRONTIER_SIZE) {
+		frontier.erase(frontier.begin());
+	}
+	frontier.push_back(tile);
+}
 
-	/* Number of times to search.
-	 * Better roads, 2X2 and 3X3 grid grow quite fast so we give
+/**
+ * Get the number of steps a town may search along its roads for a place to grow.
+ * @param t The town.
+ * @return The number of steps.
+ */
+static int GetTownGrowthSearchSteps(const Town *t)
+{
+	/* Better roads, 2X2 and 3X3 grid grow quite fast so we give
 	 * them a little handicap. */
 	switch (t->layout) {
 		case TL_BETTER_ROADS:
-			_grow_town_result = 10 + t->cache.num_houses * 2 / 9;
-			break;
+			return 10 + t->cache.num_houses * 2 / 9;
 
 		case TL_3X3_GRID:
 		case TL_2X2_GRID:
-			_grow_town_result = 10 + t->cache.num_houses * 1 / 9;
-			break;
+			return 10 + t->cache.num_houses * 1 / 9;
 
 		default:
-			_grow_town_result = 10 + t->cache.num_houses * 4 / 9;
-			break;
+			return 10 + t->cache.num_houses * 4 / 9;
 	}
+}
+
+/**
+ * Continue the search of a town along its roads for a place to grow.
+ * @param t The town to grow.
+ * @param tile The road tile to continue from.
+ * @param target_dir The direction in which the search arrived at \a tile, or DIAGDIR_END at the start of the search.
+ * @param grow_dir Direction to possibly grow in at \a tile, which was already drawn at random, or INVALID_DIAGDIR; see GrowTownInTile.
+ * @pre _grow_town_result is the number of search steps left.
+ * @return true if we successfully expanded the town.
+ */
+static bool ContinueGrowTownAtRoad(Town *t, TileIndex tile, DiagDirection target_dir, DiagDirection grow_dir = INVALID_DIAGDIR)
+{
+	assert(tile < MapSize());
 
 	do {
 		RoadBits cur_rb = GetTownRoadBits(tile); // The RoadBits of the current tile
@@ -1968,8 +2005,12 @@ static bool GrowTownAtRoad(Town *t, TileIndex tile)
 		TileIndex orig_tile = tile;
 
 		/* Try to grow the town from this point */
-		GrowTownInTile(&tile, cur_rb, target_dir, t);
-		if (_grow_town_result == GROWTH_SUCCEED) return true;
+		GrowTownInTile(&tile, cur_rb, target_dir, t, grow_dir);
+		grow_dir = INVALID_DIAGDIR;
+		if (_grow_town_result == GROWTH_SUCCEED) {
+			AddTownGrowthFrontierTile(t, tile);
+			return true;
+		}
 
 		if (orig_tile == tile) {
 			/* Exclude the source position from the bitmask
@@ -2022,6 +2063,25 @@ static bool GrowTownAtRoad(Town *t, TileIndex tile)
 	return false;
 }
 
+/**
+ * Try to grow a town at a given road tile.
+ * @param t The town to grow.
+ * @param tile The road tile to try growing from.
+ * @return true if we successfully expanded the town.
+ */
+static bool GrowTownAtRoad(Town *t, TileIndex tile)
+{
+	/* Special case.
+	 * @see GrowTownInTile Check the else if
+	 */
+	DiagDirection target_dir = DIAGDIR_END; // The direction in which we want to extend the town
+
+	/* Number of times to search. */
+	_grow_town_result = GetTownGrowthSearchSteps(t);
+
+	return ContinueGrowTownAtRoad(t, tile, target_dir);
+}
+
 /**
  * Generate a random road block.
  * The probability of a straight road
@@ -2038,6 +2098,90 @@ static RoadBits GenRandomRoadBits()
 	return (RoadBits)((ROAD_NW << a) + (ROAD_NW << b));
 }
 
+/** Offsets of the tiles around the centre of a town to look for a road to grow from, each relative to the previous tile. */
+static const TileIndexDiffC _town_coord_mod[] = {
+	{-1,  0},
+	{ 1,  1},
+	{ 1, -1},
+	{-1, -1},
+	{-1,  0},
+	{ 0,  2},
+	{ 2,  0},
+	{ 0, -2},
+	{-1, -1},
+	{-2,  2},
+	{ 2,  2},
+	{ 2, -2},
+	{ 0,  0}
+};
+
+/**
+ * Find a road near the centre of a town that we can base the construction on.
+ * @param t The town.
+ * @return The road tile, or INVALID_TILE if there is none.
+ */
+static TileIndex FindTownRoadNearCentre(const Town *t)
+{
+	TileIndex tile = t->xy;
+	for (const TileIndexDiffC *ptr = _town_coord_mod; ptr != endof(_town_coord_mod); ++ptr) {
+		if (GetTownRoadBits(tile) != ROAD_NONE) return tile;
+		tile = TILE_ADD(tile, ToTileIndexDiff(*ptr));
+	}
+	return INVALID_TILE;
+}
+
+/**
+ * Grow a town without a road near its centre, by building a random road block
+ * after clearing some land near the centre.
+ * @param t The town to grow.
+ * @pre The current company is OWNER_TOWN.
+ * @return true if we successfully built a road block.
+ */
+static bool GrowTownNewRoad(Town *t)
+{
+	if (!TownAllowedToBuildRoads(t)) return false;
+
+	TileIndex tile = t->xy;
+	for (const TileIndexDiffC *ptr = _town_coord_mod; ptr != endof(_town_coord_mod); ++ptr) {
+		/* Only work with plain land that not already has a house */
+		if (!IsTileType(tile, MP_HOUSE) && IsTileFlat(tile)) {
+			if (DoCommand(tile, 0, 0, DC_AUTO | DC_NO_WATER | DC_TOWN, CMD_LANDSCAPE_CLEAR).Succeeded()) {
+				RoadType rt = GetTownRoadType();
+				DoCommand(tile, GenRandomRoadBits() | (rt << 4), t->index, DC_EXEC | DC_AUTO | DC_TOWN, CMD_BUILD_ROAD);
+				return true;
+			}
+		}
+		tile = TILE_ADD(tile, ToTileIndexDiff(*ptr));
+	}
+	return false;
+}
+
+/**
+ * Grow a town from a road near its centre, or build a new road block when there is none.
+ * @param t The town to grow.
+ * @pre The current company is OWNER_TOWN.
+ * @return true if we successfully grew the town with a road or house.
+ */
+static bool GrowTownFromCentre(Town *t)
+{
+	TileIndex tile = FindTownRoadNearCentre(t);
+
+	/* No road available, try to build a random road block by
+	 * clearing some land and then building a road there. */
+	return (tile != INVALID_TILE) ? GrowTownAtRoad(t, tile) : GrowTownNewRoad(t);
+}
+
+/**
+ * Check whether a tile in the growth frontier of a town can still be grown from.
+ * @param t The town.
+ * @param tile The tile.
+ * @return true if the tile is still a road of the town.
+ */
+static bool IsTownGrowthFrontierTileUsable(const Town *t, TileIndex tile)
+{
+	return IsTileType(tile, MP_ROAD) && !IsRoadDepot(tile) && GetTownIndex(tile) == t->index && GetTownRoadBits(tile) != ROAD_NONE;
+}
+
 /**
  * Grow the town.
  * @param t The town to grow
@@ -2045,58 +2189,225 @@ static RoadBits GenRandomRoadBits()
  */
 static bool GrowTown(Town *t)
 {
-	static const TileIndexDiffC _town_coord_mod[] = {
-		{-1,  0},
-		{ 1,  1},
-		{ 1, -1},
-		{-1, -1},
-		{-1,  0},
-		{ 0,  2},
-		{ 2,  0},
-		{ 0, -2},
-		{-1, -1},
-		{-2,  2},
-		{ 2,  2},
-		{ 2, -2},
-		{ 0,  0}
-	};
-
 	/* Current "company" is a town */
 	Backup<CompanyID> cur_company(_current_company, OWNER_TOWN, FILE_LINE);
 
-	TileIndex tile = t->xy; // The tile we are working with ATM
-
-	/* Find a road that we can base the construction on. */
-	const TileIndexDiffC *ptr;
-	for (ptr = _town_coord_mod; ptr != endof(_town_coord_mod); ++ptr) {
-		if (GetTownRoadBits(tile) != ROAD_NONE) {
-			bool success = GrowTownAtRoad(t, tile);
+	if (_settings_game.economy.town_growth_frontier && !t->growth_frontier.empty()) {
+		/* First try to grow from a road where the town recently grew; that usually succeeds
+		 * without walking all the way from the centre. Tiles which no longer work are dropped. */
+		uint index = RandomRange((uint)t->growth_frontier.size());
+		TileIndex tile = t->growth_frontier[index];
+		if (IsTownGrowthFrontierTileUsable(t, tile) && GrowTownAtRoad(t, tile)) {
 			cur_company.Restore();
-			return success;
+			return true;
 		}
-		tile = TILE_ADD(tile, ToTileIndexDiff(*ptr));
+		t->growth_frontier.erase(t->growth_frontier.begin() + index);
 	}
 
-	/* No road available, try to build a random road block by
-	 * clearing some land and then building a road there. */
-	if (TownAllowedToBuildRoads(t)) {
-		tile = t->xy;
-		for (ptr = _town_coord_mod; ptr != endof(_town_coord_mod); ++ptr) {
-			/* Only work with plain land that not already has a house */
-			if (!IsTileType(tile, MP_HOUSE) && IsTileFlat(tile)) {
-				if (DoCommand(tile, 0, 0, DC_AUTO | DC_NO_WATER | DC_TOWN, CMD_LANDSCAPE_CLEAR).Succeeded()) {
-					RoadType rt = GetTownRoadType();
-					DoCommand(tile, GenRandomRoadBits() | (rt << 4), t->index, DC_EXEC | DC_AUTO | DC_TOWN, CMD_BUILD_ROAD);
-					cur_company.Restore();
-					return true;
-				}
-			}
-			tile = TILE_ADD(tile, ToTileIndexDiff(*ptr));
+	bool success = GrowTownFromCentre(t);
+
+	cur_company.Restore();
+	return success;
+}
+
+/** What a town does to grow in a tick, determined by #PlanTownGrowth. */
+enum TownGrowthPlanResult : uint8_t {
+	TGPR_FAIL,     ///< The search along the roads failed, the town does not grow.
+	TGPR_CONTINUE, ///< Continue the search at #TownGrowthPlan::tile, where the town might build something.
+	TGPR_NEW_ROAD, ///< There is no road near the centre, build a new road block.
+};
+
+/** The growth of a town in a tick, planned for all growing towns concurrently and then applied one town after the other. */
+struct TownGrowthPlan {
+	Town *town;                                ///< The town to grow.
+	TownGrowthPlanResult result = TGPR_FAIL;   ///< What to do.
+	TileIndex tile = INVALID_TILE;             ///< Road tile to continue the search at, for #TGPR_CONTINUE.
+	DiagDirection target_dir = DIAGDIR_END;    ///< Direction in which the search arrived at #tile.
+	DiagDirection grow_dir = INVALID_DIAGDIR;  ///< Direction to possibly grow in at #tile, drawn by the search, or INVALID_DIAGDIR.
+	int steps = 0;                             ///< Search steps left at #tile.
+	int frontier_index = -1;                   ///< Index in Town::growth_frontier where the search started, or -1.
+	bool frontier_failed = false;              ///< The search from #frontier_index failed, and started from the centre instead.
+
+	TownGrowthPlan(Town *town) : town(town) {}
+};
+
+/**
+ * Check whether GrowTownInTile would do nothing at a road tile, so the search just walks on.
+ * This draws the random direction GrowTownInTile would try, from the random stream of the plan.
+ * @param tile The road tile.
+ * @param cur_rb The town road bits of the tile.
+ * @param target_dir The direction in which the search arrived at \a tile.
+ * @param random Random stream of the plan.
+ * @param[out] grow_dir The drawn direction, which GrowTownInTile has to use when it is not passive; INVALID_DIAGDIR when none was drawn.
+ * @return true if nothing would be built at \a tile.
+ */
+static bool IsTownGrowthStepPassive(TileIndex tile, RoadBits cur_rb, DiagDirection target_dir, Randomizer &random, DiagDirection &grow_dir)
+{
+	grow_dir = INVALID_DIAGDIR;
+	if (cur_rb == ROAD_NONE) return false;
+	if (target_dir < DIAGDIR_END && !(cur_rb & DiagDirToRoadBits(ReverseDiagDir(target_dir)))) return false;
+	if (IsTileType(tile, MP_TUNNELBRIDGE)) return false;
+
+	grow_dir = (DiagDirection)random.Next(DIAGDIR_END);
+	RoadBits target_rb = DiagDirToRoadBits(grow_dir);
+
+	/* No road in this direction: the town might build a house or road next to the tile. */
+	if (!(cur_rb & target_rb)) return false;
+
+	/* Possibly a house in the corner of a turn, see GrowTownInTile. */
+	if ((cur_rb & ROAD_X) != target_rb) return true;
+	return cur_rb != ROAD_N && cur_rb != ROAD_S && cur_rb != ROAD_E && cur_rb != ROAD_W;
+}
+
+/**
+ * Plan the search of a town along its roads, up to the first tile where the town might build something.
+ * This does the same as ContinueGrowTownAtRoad for the tiles where nothing is built, but only reads the map.
+ * @param plan The plan to fill.
+ * @param tile The road tile to start from.
+ * @param random Random stream of the plan.
+ * @return false if the search fails before reaching such a tile.
+ */
+static bool PlanTownGrowthAtRoad(TownGrowthPlan &plan, TileIndex tile, Randomizer &random)
+{
+	const Town *t = plan.town;
+	DiagDirection target_dir = DIAGDIR_END;
+	int steps = GetTownGrowthSearchSteps(t);
+
+	do {
+		RoadBits cur_rb = GetTownRoadBits(tile);
+		DiagDirection grow_dir;
+		if (!IsTownGrowthStepPassive(tile, cur_rb, target_dir, random, grow_dir)) {
+			plan.result = TGPR_CONTINUE;
+			plan.tile = tile;
+			plan.target_dir = target_dir;
+			plan.grow_dir = grow_dir;
+			plan.steps = steps;
+			return true;
+		}
+
+		/* Passive tiles are never tunnels or bridges, so just pick the next road bit. */
+		if (IsValidDiagDirection(target_dir)) cur_rb &= ~DiagDirToRoadBits(ReverseDiagDir(target_dir));
+		do {
+			if (cur_rb == ROAD_NONE) return false;
+			RoadBits target_bits;
+			do {
+				target_dir = (DiagDirection)random.Next(DIAGDIR_END);
+				target_bits = DiagDirToRoadBits(target_dir);
+			} while (!(cur_rb & target_bits));
+			cur_rb &= ~target_bits;
+		} while (!CanFollowRoad(t, tile, target_dir));
+		tile = TileAddByDiagDir(tile, target_dir);
+
+		/* Don't allow building over roads of other cities */
+		if (IsTileType(tile, MP_ROAD) && !IsRoadDepot(tile) && HasTileRoadType(tile, RTT_ROAD) &&
+				IsRoadOwner(tile, RTT_ROAD, OWNER_TOWN) && Town::GetByTile(tile) != t) {
+			return false;
 		}
+	} while (--steps >= 0);
+
+	return false;
+}
+
+/**
+ * Plan the growth of a town, like GrowTown does.
+ * This only reads the map and the town, so it can be done for many towns concurrently.
+ * @param plan The plan to fill.
+ * @param random Random stream of the plan.
+ */
+static void PlanTownGrowth(TownGrowthPlan &plan, Randomizer &random)
+{
+	const Town *t = plan.town;
+
+	if (_settings_game.economy.town_growth_frontier && !t->growth_frontier.empty()) {
+		plan.frontier_index = random.Next((uint)t->growth_frontier.size());
+		TileIndex tile = t->growth_frontier[plan.frontier_index];
+		if (IsTownGrowthFrontierTileUsable(t, tile) && PlanTownGrowthAtRoad(plan, tile, random)) return;
+		plan.frontier_failed = true;
+	}
+
+	TileIndex tile = FindTownRoadNearCentre(t);
+	if (tile == INVALID_TILE) {
+		plan.result = TGPR_NEW_ROAD;
+		return;
+	}
+	PlanTownGrowthAtRoad(plan, tile, random);
+}
+
+/**
+ * Grow a town according to its plan.
+ * @param plan The plan.
+ * @return true if we successfully grew the town with a road or house.
+ */
+static bool ApplyTownGrowthPlan(const TownGrowthPlan &plan)
+{
+	Town *t = plan.town;
+
+	/* Drop a failed frontier tile first, growing may add tiles to the frontier. */
+	if (plan.frontier_failed) t->growth_frontier.erase(t->growth_frontier.begin() + plan.frontier_index);
+
+	Backup<CompanyID> cur_company(_current_company, OWNER_TOWN, FILE_LINE);
+
+	bool success = false;
+	switch (plan.result) {
+		case TGPR_FAIL:
+			break;
+
+		case TGPR_CONTINUE:
+			_grow_town_result = plan.steps;
+			success = ContinueGrowTownAtRoad(t, plan.tile, plan.target_dir, plan.grow_dir);
+			break;
+
+		case TGPR_NEW_ROAD:
+			success = GrowTownNewRoad(t);
+			break;
+	}
+
+	if (!success && plan.frontier_index >= 0 && !plan.frontier_failed) {
+		/* Like GrowTown, drop the frontier tile and try again from the centre in this tick, with the game's random stream. */
+		t->growth_frontier.erase(t->growth_frontier.begin() + plan.frontier_index);
+		success = GrowTownFromCentre(t);
 	}
 
 	cur_company.Restore();
-	return false;
+	return success;
+}
+
+/**
+ * Town tick for all towns, with the search for a place to grow planned for all growing towns concurrently.
+ * Each town uses its own random stream for its plan, seeded from the game's random stream, and the plans are
+ * applied in the order of the towns. So the result is the same on every machine, whatever the number of threads.
+ */
+static void OnTick_TownParallel()
+{
+	static std::vector<TownGrowthPlan> plans;
+	plans.clear();
+
+	for (Town *t : Town::Iterate()) {
+		if (!HasBit(t->flags, TOWN_IS_GROWING)) continue;
+		if (t->grow_counter > 0) {
+			t->grow_counter--;
+			continue;
+		}
+		plans.emplace_back(t);
+	}
+	if (plans.empty()) return;
+
+	const uint32_t seed = Random();
+	_general_worker_pool.ParallelFor((uint)plans.size(), [&](uint i) {
+		Randomizer random;
+		random.SetSeed(seed ^ (plans[i].town->index * 0x9E3779B9));
+		PlanTownGrowth(plans[i], random);
+	});
+
+	for (const TownGrowthPlan &plan : plans) {
+		Town *t = plan.town;
+		if (ApplyTownGrowthPlan(plan)) {
+			t->grow_counter = t->growth_rate;
+		} else {
+			/* If growth failed wait a bit before retrying */
+			t->grow_counter = std::min<uint16_t>(t->growth_rate, TOWN_GROWTH_TICKS - 1);
+		}
+	}
 }
 
 /**
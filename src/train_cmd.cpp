@@ -831,6 +831,30 @@ static int64_t GetRealisticBrakingDistanceForSpeed(const TrainDecelerationStats
 	return dist;
 }
 
+/**
+ * Check whether braking from \a start_speed to \a end_speed takes longer than \a distance.
+ * This is equivalent to GetRealisticBrakingDistanceForSpeed(stats, start_speed, end_speed, z_delta) > distance,
+ * but avoids the divisions, as this is evaluated for every look-ahead item of every train on each tick.
+ * @pre start_speed > end_speed, distance >= 0
+ */
+static bool IsRealisticBrakingDistanceForSpeedGreaterThan(const TrainDecelerationStats &stats, int start_speed, int end_speed, int z_delta, int distance)
+{
+	auto sqr = [](int64_t speed) -> int64_t { return speed * speed; };
+
+	/* For n > 0 and d > 0: n / d > distance, if and only if n >= (distance + 1) * d */
+	const int64_t limit = (int64_t)distance + 1;
+
+	int64_t ke_delta = sqr(start_speed) - sqr(end_speed);
+	if (ke_delta >= limit * stats.deceleration_x2) return true;
+
+	if (z_delta < 0 && _settings_game.vehicle.train_acceleration_model != AM_ORIGINAL) {
+		/* descending, see GetRealisticBrakingDistanceForSpeed */
+		int64_t slope_ke_delta = ke_delta - (z_delta * ((400 * 5) / 18) * _settings_game.vehicle.train_slope_steepness);
+		if (slope_ke_delta >= limit * stats.uncapped_deceleration_x2) return true;
+	}
+	return false;
+}
+
 static int GetRealisticBrakingSpeedForDistance(const TrainDecelerationStats &stats, int distance, int end_speed, int z_delta)
 {
 	/* v^2 = u^2 + 2as */
@@ -899,8 +923,7 @@ void LimitSpeedFromLookAhead(int &max_speed, const TrainDecelerationStats &stats
 	if (position <= current_position) {
 		max_speed = std::min(max_speed, std::max(15, end_speed));
 	} else if (end_speed < max_speed) {
-		int64_t distance = GetRealisticBrakingDistanceForSpeed(stats, max_speed, end_speed, z_delta);
-		if (distance + current_position > position) {
+		if (IsRealisticBrakingDistanceForSpeedGreaterThan(stats, max_speed, end_speed, z_delta, position - current_position)) {
 			/* Speed is too fast, we would overshoot */
 			if (z_delta < 0 && (position - current_position) < stats.t->gcache.cached_total_length) {
 				int effective_length = std::min<int>(stats.t->gcache.cached_total_length, stats.t->tcache.cached_centre_mass * 2);
@@ -1123,6 +1146,8 @@ Train::MaxSpeedInfo Train::GetCurrentMaxSpeedInfoInternal(bool update_state) con
 			const Order *order = &(this->current_order);
 			StationID last_station_visited = this->last_station_visited;
 			for (const TrainReservationLookAheadItem &item : this->lookahead->items) {
+				/* No look-ahead item can reduce the speeds below the minimum braking speed */
+				if (max_speed <= REALISTIC_BRAKING_MIN_SPEED && advisory_max_speed <= REALISTIC_BRAKING_MIN_SPEED) break;
 				ApplyLookAheadItem(this, item, max_speed, advisory_max_speed, current_order_index, order, last_station_visited, stats, this->lookahead->current_position);
 			}
 			if (HasBit(this->lookahead->flags, TRLF_APPLY_ADVISORY)) {
@@ -2603,16 +2628,6 @@ void ReverseTrainSwapVeh(Train *v, int l, int r)
 }
 
 
-/**
- * Check if the vehicle is a train
- * @param v vehicle on tile
- * @return v if it is a train, nullptr otherwise
- */
-static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
-{
-	return v;
-}
-
 /**
  * Check if a level crossing tile has a train on it
  * @param tile tile to test
@@ -2623,28 +2638,24 @@ bool TrainOnCrossing(TileIndex tile)
 {
 	assert(IsLevelCrossingTile(tile));
 
-	return HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum);
+	return HasAnyVehicleOnPos(tile, VEH_TRAIN);
 }
 
 
 /**
  * Checks if a train is approaching a rail-road crossing
  * @param v vehicle on tile
- * @param data tile with crossing we are testing
- * @return v if it is approaching a crossing, nullptr otherwise
+ * @param tile tile with crossing we are testing
+ * @return true if it is approaching the crossing
  */
-static Vehicle *TrainApproachingCrossingEnum(Vehicle *v, void *data)
+static bool IsTrainApproachingCrossing(const Vehicle *v, TileIndex tile)
 {
-	if ((v->vehstatus & VS_CRASHED)) return nullptr;
-
-	Train *t = Train::From(v);
-	if (!t->IsFrontEngine()) return nullptr;
-
-	TileIndex tile = (TileIndex) reinterpret_cast<uintptr_t>(data);
+	if ((v->vehstatus & VS_CRASHED)) return false;
 
-	if (TrainApproachingCrossingTile(t) != tile) return nullptr;
+	const Train *t = Train::From(v);
+	if (!t->IsFrontEngine()) return false;
 
-	return t;
+	return TrainApproachingCrossingTile(t) == tile;
 }
 
 
@@ -2661,12 +2672,13 @@ static bool TrainApproachingCrossing(TileIndex tile)
 	DiagDirection dir = AxisToDiagDir(GetCrossingRailAxis(tile));
 	TileIndex tile_from = tile + TileOffsByDiagDir(dir);
 
-	if (HasVehicleOnPos(tile_from, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainApproachingCrossingEnum)) return true;
+	auto approaching = [tile](const Vehicle *v) { return IsTrainApproachingCrossing(v, tile); };
+	if (HasVehicleOnPos(tile_from, VEH_TRAIN, approaching)) return true;
 
 	dir = ReverseDiagDir(dir);
 	tile_from = tile + TileOffsByDiagDir(dir);
 
-	return HasVehicleOnPos(tile_from, VEH_TRAIN, reinterpret_cast<void *>((uintptr_t)tile), &TrainApproachingCrossingEnum);
+	return HasVehicleOnPos(tile_from, VEH_TRAIN, approaching);
 }
 
 /** Check if the crossing should be closed
@@ -5072,26 +5084,23 @@ struct TrainCollideChecker {
 /**
  * Collision test function.
  * @param v %Train vehicle to test collision with.
- * @param data %Train being examined.
- * @return \c nullptr (always continue search)
+ * @param tcc %Train being examined.
  */
-static Vehicle *FindTrainCollideEnum(Vehicle *v, void *data)
+static inline void FindTrainCollide(Vehicle *v, TrainCollideChecker *tcc)
 {
-	TrainCollideChecker *tcc = (TrainCollideChecker*)data;
-
 	/* not in depot */
-	if (Train::From(v)->track == TRACK_BIT_DEPOT) return nullptr;
+	if (Train::From(v)->track == TRACK_BIT_DEPOT) return;
 
 	if (_settings_game.vehicle.no_train_crash_other_company) {
 		/* do not crash into trains of another company. */
-		if (v->owner != tcc->v->owner) return nullptr;
+		if (v->owner != tcc->v->owner) return;
 	}
 
 	/* get first vehicle now to make most usual checks faster */
 	Train *coll = Train::From(v)->First();
 
 	/* can't collide with own wagons */
-	if (coll == tcc->v) return nullptr;
+	if (coll == tcc->v) return;
 
 	int x_diff = v->x_pos - tcc->v->x_pos;
 	int y_diff = v->y_pos - tcc->v->y_pos;
@@ -5101,20 +5110,18 @@ static Vehicle *FindTrainCollideEnum(Vehicle *v, void *data)
 	 * Differences are shifted by 7, mapping range [-7 .. 8] into [0 .. 15]
 	 * Differences are then ORed and then we check for any higher bits */
 	uint hash = (y_diff + 7) | (x_diff + 7);
-	if (hash & ~15) return nullptr;
+	if (hash & ~15) return;
 
 	/* Slower check using multiplication */
 	int min_diff = (Train::From(v)->gcache.cached_veh_length + 1) / 2 + (tcc->v->gcache.cached_veh_length + 1) / 2 - 1;
-	if (x_diff * x_diff + y_diff * y_diff >= min_diff * min_diff) return nullptr;
+	if (x_diff * x_diff + y_diff * y_diff >= min_diff * min_diff) return;
 
 	/* Happens when there is a train under bridge next to bridge head */
-	if (abs(v->z_pos - tcc->v->z_pos) > 5) return nullptr;
+	if (abs(v->z_pos - tcc->v->z_pos) > 5) return;
 
 	/* crash both trains */
 	tcc->num += TrainCrashed(tcc->v);
 	tcc->num += TrainCrashed(coll);
-
-	return nullptr; // continue searching
 }
 
 /**
@@ -5136,11 +5143,12 @@ static bool CheckTrainCollision(Train *v)
 	tcc.num = 0;
 
 	/* find colliding vehicles */
+	auto collide = [&tcc](Vehicle *u) { FindTrainCollide(u, &tcc); };
 	if (v->track & TRACK_BIT_WORMHOLE) {
-		FindVehicleOnPos(v->tile, VEH_TRAIN, &tcc, FindTrainCollideEnum);
-		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), VEH_TRAIN, &tcc, FindTrainCollideEnum);
+		FindVehicleOnPos(v->tile, VEH_TRAIN, collide);
+		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), VEH_TRAIN, collide);
 	} else {
-		FindVehicleOnPosXY(v->x_pos, v->y_pos, VEH_TRAIN, &tcc, FindTrainCollideEnum);
+		FindVehicleOnPosXY(v->x_pos, v->y_pos, VEH_TRAIN, collide);
 	}
 
 	/* any dead -> no crash */
@@ -5176,29 +5184,27 @@ struct FindSpaceBetweenTrainsChecker {
 };
 
 /** Find train in front and keep distance between trains in tunnel/bridge. */
-static Vehicle *FindSpaceBetweenTrainsEnum(Vehicle *v, void *data)
+static inline bool FindSpaceBetweenTrains(const Vehicle *v, const FindSpaceBetweenTrainsChecker &checker)
 {
 	/* Don't look at wagons between front and back of train. */
-	if ((v->Previous() != nullptr && v->Next() != nullptr)) return nullptr;
+	if ((v->Previous() != nullptr && v->Next() != nullptr)) return false;
 
 	if (!IsDiagonalDirection(v->direction)) {
 		/* Check for vehicles on non-across track pieces of custom bridge head */
-		if ((GetAcrossTunnelBridgeTrackBits(v->tile) & Train::From(v)->track & TRACK_BIT_ALL) == TRACK_BIT_NONE) return nullptr;
+		if ((GetAcrossTunnelBridgeTrackBits(v->tile) & Train::From(v)->track & TRACK_BIT_ALL) == TRACK_BIT_NONE) return false;
 	}
 
-	const FindSpaceBetweenTrainsChecker *checker = (FindSpaceBetweenTrainsChecker*) data;
 	int32_t a, b = 0;
 
-	switch (checker->direction) {
+	switch (checker.direction) {
 		default: NOT_REACHED();
-		case DIAGDIR_NE: a = checker->pos; b = v->x_pos; break;
-		case DIAGDIR_SE: a = v->y_pos; b = checker->pos; break;
-		case DIAGDIR_SW: a = v->x_pos; b = checker->pos; break;
-		case DIAGDIR_NW: a = checker->pos; b = v->y_pos; break;
+		case DIAGDIR_NE: a = checker.pos; b = v->x_pos; break;
+		case DIAGDIR_SE: a = v->y_pos; b = checker.pos; break;
+		case DIAGDIR_SW: a = v->x_pos; b = checker.pos; break;
+		case DIAGDIR_NW: a = checker.pos; b = v->y_pos; break;
 	}
 
-	if (a > b && a <= (b + (int)(checker->distance)) + (int)(TILE_SIZE) - 1) return v;
-	return nullptr;
+	return a > b && a <= (b + (int)(checker.distance)) + (int)(TILE_SIZE) - 1;
 }
 
 static bool IsTooCloseBehindTrain(Train *t, TileIndex tile, uint16_t distance, bool check_endtile)
@@ -5249,7 +5255,8 @@ static bool IsTooCloseBehindTrain(Train *t, TileIndex tile, uint16_t distance, b
 		case DIAGDIR_NW: checker.pos = (TileY(tile) * TILE_SIZE) + TILE_UNIT_MASK; break;
 	}
 
-	if (HasVehicleOnPos(t->tile, VEH_TRAIN, &checker, &FindSpaceBetweenTrainsEnum)) {
+	auto too_close = [&checker](const Vehicle *v) { return FindSpaceBetweenTrains(v, checker); };
+	if (HasVehicleOnPos(t->tile, VEH_TRAIN, too_close)) {
 		/* Revert train if not going with tunnel direction. */
 		if (checker.direction != GetTunnelBridgeDirection(t->tile)) {
 			SetBit(t->flags, VRF_REVERSING);
@@ -5258,7 +5265,7 @@ static bool IsTooCloseBehindTrain(Train *t, TileIndex tile, uint16_t distance, b
 	}
     /* Cover blind spot at end of tunnel bridge. */
 	if (check_endtile){
-		if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(t->tile), VEH_TRAIN, &checker, &FindSpaceBetweenTrainsEnum)) {
+		if (HasVehicleOnPos(GetOtherTunnelBridgeEnd(t->tile), VEH_TRAIN, too_close)) {
 			/* Revert train if not going with tunnel direction. */
 			if (checker.direction != GetTunnelBridgeDirection(t->tile)) {
 				SetBit(t->flags, VRF_REVERSING);
@@ -6263,10 +6270,10 @@ static bool IsRailStationPlatformOccupied(TileIndex tile)
 	TileIndexDiff delta = (GetRailStationAxis(tile) == AXIS_X ? TileDiffXY(1, 0) : TileDiffXY(0, 1));
 
 	for (TileIndex t = tile; IsCompatibleTrainStationTile(t, tile); t -= delta) {
-		if (HasVehicleOnPos(t, VEH_TRAIN, nullptr, &TrainOnTileEnum)) return true;
+		if (HasAnyVehicleOnPos(t, VEH_TRAIN)) return true;
 	}
 	for (TileIndex t = tile + delta; IsCompatibleTrainStationTile(t, tile); t += delta) {
-		if (HasVehicleOnPos(t, VEH_TRAIN, nullptr, &TrainOnTileEnum)) return true;
+		if (HasAnyVehicleOnPos(t, VEH_TRAIN)) return true;
 	}
 
 	return false;
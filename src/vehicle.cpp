@@ -492,31 +492,55 @@ Vehicle::Vehicle(VehicleType type)
 using VehicleTypeTileHash = robin_hood::unordered_map<TileIndex, VehicleID>;
 static std::array<VehicleTypeTileHash, 4> _vehicle_tile_hashes;
 
-static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
+/**
+ * Get the first vehicle of a type in the tile hash chain of a tile.
+ * @param tile The location on the map
+ * @param type The vehicle type
+ * @return The first vehicle, or nullptr if there are no vehicles of this type on the tile.
+ */
+Vehicle *GetFirstVehicleOnPos(TileIndex tile, VehicleType type)
 {
-	VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
+	const VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
 
-	for (int y = yl; ; y++) {
-		for (int x = xl; ; x++) {
-			auto iter = vhash.find(TileXY(x, y));
-			if (iter != vhash.end()) {
-				Vehicle *v = Vehicle::Get(iter->second);
-				do {
-					Vehicle *a = proc(v, data);
-					if (find_first && a != nullptr) return a;
+	auto iter = vhash.find(tile);
+	if (iter == vhash.end()) return nullptr;
+	return Vehicle::Get(iter->second);
+}
 
-					v = v->hash_tile_next;
-				} while (v != nullptr);
-			}
-			if (x == xu) break;
+/**
+ * Get the first vehicle of a type in the tile hash chain of each tile near a pixel position.
+ * The area covers all tiles within collision distance of the position, this is at most 2x2 tiles.
+ * @param x    The X location on the map
+ * @param y    The Y location on the map
+ * @param type The vehicle type
+ * @return The first vehicles of the occupied tiles, in Y then X order.
+ */
+VehicleTileHashHeads GetVehicleTileHashHeadsXY(int x, int y, VehicleType type)
+{
+	const int COLL_DIST = 6;
+	static_assert(COLL_DIST * 2 < (int)TILE_SIZE);
+
+	/* Hash area to scan is from xl,yl to xu,yu */
+	int xl = (x - COLL_DIST) / TILE_SIZE;
+	int xu = (x + COLL_DIST) / TILE_SIZE;
+	int yl = (y - COLL_DIST) / TILE_SIZE;
+	int yu = (y + COLL_DIST) / TILE_SIZE;
+
+	const VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
+
+	VehicleTileHashHeads result;
+	for (int ty = yl; ; ty++) {
+		for (int tx = xl; ; tx++) {
+			auto iter = vhash.find(TileXY(tx, ty));
+			if (iter != vhash.end()) result.heads[result.count++] = Vehicle::Get(iter->second);
+			if (tx == xu) break;
 		}
-		if (y == yu) break;
+		if (ty == yu) break;
 	}
 
-	return nullptr;
+	return result;
 }
 
-
 /**
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
  * @note Do not call this function directly!
@@ -530,15 +554,16 @@ static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, VehicleType
  */
 Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	const int COLL_DIST = 6;
+	for (Vehicle *v : GetVehicleTileHashHeadsXY(x, y, type)) {
+		do {
+			Vehicle *a = proc(v, data);
+			if (find_first && a != nullptr) return a;
 
-	/* Hash area to scan is from xl,yl to xu,yu */
-	int xl = (x - COLL_DIST) / TILE_SIZE;
-	int xu = (x + COLL_DIST) / TILE_SIZE;
-	int yl = (y - COLL_DIST) / TILE_SIZE;
-	int yu = (y + COLL_DIST) / TILE_SIZE;
+			v = v->hash_tile_next;
+		} while (v != nullptr);
+	}
 
-	return VehicleFromTileHash(xl, yl, xu, yu, type, data, proc, find_first);
+	return nullptr;
 }
 
 /**
@@ -553,17 +578,9 @@ Vehicle *VehicleFromPosXY(int x, int y, VehicleType type, void *data, VehicleFro
  */
 Vehicle *VehicleFromPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	VehicleTypeTileHash &vhash = _vehicle_tile_hashes[type];
-
-	auto iter = vhash.find(tile);
-	if (iter != vhash.end()) {
-		Vehicle *v = Vehicle::Get(iter->second);
-		do {
-			Vehicle *a = proc(v, data);
-			if (find_first && a != nullptr) return a;
-
-			v = v->hash_tile_next;
-		} while (v != nullptr);
+	for (Vehicle *v = GetFirstVehicleOnPos(tile, type); v != nullptr; v = v->hash_tile_next) {
+		Vehicle *a = proc(v, data);
+		if (find_first && a != nullptr) return a;
 	}
 
 	return nullptr;
@@ -27,6 +27,7 @@
 #include "core/mem_func.hpp"
 #include "core/endian_type.hpp"
 #include "sl/saveload_common.h"
+#include <array>
 #include <list>
 #include <map>
 #include <vector>
@@ -1363,6 +1364,102 @@ public:
 	}
 };
 
+/**
+ * First vehicle in the tile hash chain of each occupied tile in an area, in the order the tiles are scanned.
+ * The vehicles of each tile are reached through Vehicle::hash_tile_next.
+ */
+struct VehicleTileHashHeads {
+	std::array<Vehicle *, 4> heads; ///< First vehicle of each occupied tile.
+	uint count = 0;                 ///< Number of valid items in #heads.
+
+	Vehicle * const *begin() const { return this->heads.data(); }
+	Vehicle * const *end() const { return this->heads.data() + this->count; }
+};
+
+Vehicle *GetFirstVehicleOnPos(TileIndex tile, VehicleType type);
+VehicleTileHashHeads GetVehicleTileHashHeadsXY(int x, int y, VehicleType type);
+
+/**
+ * Checks whether there is any vehicle of a type on a tile.
+ * @param tile The location on the map
+ * @param type The vehicle type
+ * @return True if there is a vehicle of this type on the tile.
+ */
+inline bool HasAnyVehicleOnPos(TileIndex tile, VehicleType type)
+{
+	return GetFirstVehicleOnPos(tile, type) != nullptr;
+}
+
+/**
+ * Call \a proc for all vehicles of a type on a tile.
+ * Unlike the #VehicleFromPosProc variant, \a proc can be inlined into the search loop.
+ * The same caveats about the result being independent of the order of the vehicles apply.
+ * @param tile The location on the map
+ * @param type The vehicle type
+ * @param proc Function called as void proc(Vehicle *v).
+ */
+template <typename F>
+inline void FindVehicleOnPos(TileIndex tile, VehicleType type, F proc)
+{
+	for (Vehicle *v = GetFirstVehicleOnPos(tile, type); v != nullptr; v = v->hash_tile_next) {
+		proc(v);
+	}
+}
+
+/**
+ * Checks whether a vehicle of a type on a tile matches \a proc, stopping at the first match.
+ * Unlike the #VehicleFromPosProc variant, \a proc can be inlined into the search loop.
+ * @param tile The location on the map
+ * @param type The vehicle type
+ * @param proc Function called as bool proc(Vehicle *v).
+ * @return True if proc returned true for any vehicle.
+ */
+template <typename F>
+inline bool HasVehicleOnPos(TileIndex tile, VehicleType type, F proc)
+{
+	for (Vehicle *v = GetFirstVehicleOnPos(tile, type); v != nullptr; v = v->hash_tile_next) {
+		if (proc(v)) return true;
+	}
+	return false;
+}
+
+/**
+ * Call \a proc for all vehicles of a type near a pixel position, see #FindVehicleOnPosXY.
+ * The hash lookups for all tiles in the area are done in one go, before any vehicle is visited.
+ * @param x    The X location on the map
+ * @param y    The Y location on the map
+ * @param type The vehicle type
+ * @param proc Function called as void proc(Vehicle *v).
+ */
+template <typename F>
+inline void FindVehicleOnPosXY(int x, int y, VehicleType type, F proc)
+{
+	for (Vehicle *first : GetVehicleTileHashHeadsXY(x, y, type)) {
+		for (Vehicle *v = first; v != nullptr; v = v->hash_tile_next) {
+			proc(v);
+		}
+	}
+}
+
+/**
+ * Checks whether a vehicle of a type near a pixel position matches \a proc, stopping at the first match.
+ * @param x    The X location on the map
+ * @param y    The Y location on the map
+ * @param type The vehicle type
+ * @param proc Function called as bool proc(Vehicle *v).
+ * @return True if proc returned true for any vehicle.
+ */
+template <typename F>
+inline bool HasVehicleOnPosXY(int x, int y, VehicleType type, F proc)
+{
+	for (Vehicle *first : GetVehicleTileHashHeadsXY(x, y, type)) {
+		for (Vehicle *v = first; v != nullptr; v = v->hash_tile_next) {
+			if (proc(v)) return true;
+		}
+	}
+	return false;
+}
+
 inline bool IsPointInViewportVehicleRedrawArea(const std::vector<Rect> &viewport_redraw_rects, const Point &pt)
 {
 	for (const Rect &r : viewport_redraw_rects) {
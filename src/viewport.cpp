@@ -65,6 +65,7 @@
 #include "tree_map.h"
 #include "industry.h"
 #include "smallmap_gui.h"
+#include "screenshot.h"
 #include "smallmap_colours.h"
 #include "table/tree_land.h"
 #include "blitter/32bpp_base.hpp"
@@ -131,6 +132,10 @@
 #include <mutex>
 #include <condition_variable>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "table/strings.h"
 #include "table/string_colours.h"
 
@@ -276,6 +281,7 @@ static ViewportDrawer _vd;
 struct ViewportProcessParentSpritesData {
 	DrawPixelInfo dpi;
 	ParentSpriteToSortVector psts;
+	ParentSpriteToDrawVector sprites; ///< Copies of the parent sprites in psts, used when the drawing region has been split
 };
 
 /** Data structure storing rendering information */
@@ -296,6 +302,7 @@ struct ViewportDrawerDynamic {
 	uint8_t display_flags;
 
 	std::atomic<uint> draw_jobs_active;
+	std::atomic<TimingMeasurement> sort_time;
 
 	TransparencyOptionBits transparency_opt;
 	TransparencyOptionBits invisibility_opt;
@@ -3393,17 +3400,40 @@ static inline void ViewportMapStoreBridgeAboveTile(const Viewport * const vp, co
 	}
 }
 
-static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * const vp, const TileIndex from_tile, TileType * const tile_type)
+/** Bridge tile found while computing the colours of the viewport map. */
+struct ViewportMapBridgeTile {
+	TileIndex tile;   ///< The tile.
+	bool bridge_head; ///< Whether this is a bridge head, otherwise it is a tile below a bridge.
+};
+
+/**
+ * Bridge tiles found while computing the colours of the viewport map.
+ * These are stored in the viewport drawer once the colours have been computed, as the colours may be computed concurrently.
+ */
+using ViewportMapBridgeTiles = std::vector<ViewportMapBridgeTile>;
+
+static void ViewportMapStoreBridgeTiles(const Viewport * const vp, const ViewportMapBridgeTiles &bridges)
+{
+	for (const ViewportMapBridgeTile &it : bridges) {
+		if (it.bridge_head) {
+			ViewportMapStoreBridge(vp, it.tile);
+		} else {
+			ViewportMapStoreBridgeAboveTile(vp, it.tile);
+		}
+	}
+}
+
+static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * const vp, const TileIndex from_tile, TileType * const tile_type, ViewportMapBridgeTiles &bridges)
 {
 	if (vp->zoom <= ZOOM_LVL_OUT_128X) {
 		const TileType ttype = GetTileType(from_tile);
 		/* Store bridges and tunnels. */
 		if (ttype != MP_TUNNELBRIDGE) {
 			*tile_type = ttype;
-			if (IsBridgeAbove(from_tile)) ViewportMapStoreBridgeAboveTile(vp, from_tile);
+			if (IsBridgeAbove(from_tile)) bridges.push_back({ from_tile, false });
 		} else {
 			if (IsBridge(from_tile)) {
-				ViewportMapStoreBridge(vp, from_tile);
+				bridges.push_back({ from_tile, true });
 			}
 			switch (GetTunnelBridgeTransportType(from_tile)) {
 				case TRANSPORT_RAIL:  *tile_type = MP_RAILWAY; break;
@@ -3430,7 +3460,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 			result = tile;
 		}
 		if (ttype != MP_TUNNELBRIDGE && IsBridgeAbove(tile)) {
-			ViewportMapStoreBridgeAboveTile(vp, tile);
+			bridges.push_back({ tile, false });
 		}
 	}
 
@@ -3438,7 +3468,7 @@ static inline TileIndex ViewportMapGetMostSignificantTileType(const Viewport * c
 	*tile_type = GetTileType(result);
 	if (*tile_type == MP_TUNNELBRIDGE) {
 		if (IsBridge(result)) {
-			ViewportMapStoreBridge(vp, result);
+			bridges.push_back({ result, true });
 		}
 		switch (GetTunnelBridgeTransportType(result)) {
 			case TRANSPORT_RAIL: *tile_type = MP_RAILWAY; break;
@@ -3457,7 +3487,7 @@ static uint32_t ViewportMapVoidColour()
 
 /** Get the colour of a tile, can be 32bpp RGB or 8bpp palette index. */
 template <bool is_32bpp, bool show_slope>
-uint32_t ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint colour_index)
+uint32_t ViewportMapGetColour(const Viewport * const vp, int x, int y, const uint colour_index, ViewportMapBridgeTiles &bridges)
 {
 	if (x >= static_cast<int>(MapMaxX() * TILE_SIZE) || y >= static_cast<int>(MapMaxY() * TILE_SIZE)) return ViewportMapVoidColour();
 
@@ -3481,7 +3511,7 @@ uint32_t ViewportMapGetColour(const Viewport * const vp, int x, int y, const uin
 		if (tile >= MapSize()) return ViewportMapVoidColour();
 	}
 	TileType tile_type = MP_VOID;
-	tile = ViewportMapGetMostSignificantTileType(vp, tile, &tile_type);
+	tile = ViewportMapGetMostSignificantTileType(vp, tile, &tile_type, bridges);
 	if (tile_type == MP_VOID) return ViewportMapVoidColour();
 
 	/* Return the colours. */
@@ -3516,6 +3546,33 @@ static inline void PixelBlend(uint32_t * const d, const uint32_t s)
 	*d = rb | g;
 }
 
+/**
+ * Blend a colour over a run of pixels.
+ * This is equivalent to calling PixelBlend() for each pixel, up to rounding.
+ * @param d First pixel of the run.
+ * @param count Number of pixels.
+ * @param s Colour to blend, including alpha.
+ */
+static inline void PixelBlendRun(uint32_t *d, int count, const uint32_t s)
+{
+#if defined(__SSE2__)
+	const uint a = (s >> 24) + 1;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i src = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32(s & 0xFFFFFF), zero), _mm_set1_epi16(a));
+	const __m128i dst_weight = _mm_set1_epi16(256 - a);
+	const __m128i rgb_mask = _mm_set1_epi32(0xFFFFFF);
+	for (; count >= 4; count -= 4, d += 4) {
+		const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(d));
+		const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), dst_weight), src), 8);
+		const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), dst_weight), src), 8);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(d), _mm_and_si128(_mm_packus_epi16(lo, hi), rgb_mask));
+	}
+#endif
+	for (; count > 0; count--, d++) {
+		PixelBlend(d, s);
+	}
+}
+
 /** Draw the bounding boxes of the scrolling viewport (right-clicked and dragged) */
 static void ViewportMapDrawScrollingViewportBox(const Viewport * const vp)
 {
@@ -3542,9 +3599,7 @@ static void ViewportMapDrawScrollingViewportBox(const Viewport * const vp)
 					if (_settings_client.gui.show_scrolling_viewport_on_map >= 2 && blitter->GetScreenDepth() == 32) {
 						for (int j = t_inter; j < b_inter; j++) {
 							uint32_t *buf = (uint32_t*) blitter->MoveTo(_vdd->dpi.dst_ptr, 0, j);
-							for (int i = l_inter; i < r_inter; i++) {
-								PixelBlend(buf + i, 0x40FCFCFC);
-							}
+							PixelBlendRun(buf + l_inter, r_inter - l_inter, 0x40FCFCFC);
 						}
 					}
 
@@ -3613,10 +3668,7 @@ static void ViewportMapDrawSelection(const Viewport * const vp)
 		points[2] = end_pt;
 		points[3] = mid2_pt;
 		GfxFillPolygon(points, 0, FILLRECT_FUNCTOR, [](void *dst, int count) {
-			uint32_t *buf = reinterpret_cast<uint32_t *>(dst);
-			for (int i = 0; i < count; i++) {
-				PixelBlend(buf + i, 0x40FCFCFC);
-			}
+			PixelBlendRun(reinterpret_cast<uint32_t *>(dst), count, 0x40FCFCFC);
 		});
 	} else {
 		draw_line(start_pt, end_pt);
@@ -3691,6 +3743,70 @@ static void ViewportMapDrawBridgeTunnel(Viewport * const vp, const TunnelBridgeT
 	}
 }
 
+/**
+ * Find the next pixel of a line of the land pixel cache which has not been computed yet.
+ * @param cache Start of the line.
+ * @param i Index of the first pixel to check.
+ * @param w Width of the line.
+ * @return Index of the first uncached pixel at or after i, or w if there is none.
+ */
+static inline int ViewportMapFindUncachedPixel(const uint32_t * const cache, int i, const int w)
+{
+#if defined(__SSE2__)
+	const __m128i uncached = _mm_set1_epi32(0xD7D7D7D7);
+	for (; i + 4 <= w; i += 4) {
+		const uint mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(cache + i)), uncached));
+		if (mask != 0) return i + (std::countr_zero(mask) / 4);
+	}
+#endif
+	for (; i < w; i++) {
+		if (cache[i] == 0xD7D7D7D7) return i;
+	}
+	return w;
+}
+
+/** @copydoc ViewportMapFindUncachedPixel(const uint32_t * const, int, const int) */
+static inline int ViewportMapFindUncachedPixel(const uint8_t * const cache, int i, const int w)
+{
+#if defined(__SSE2__)
+	const __m128i uncached = _mm_set1_epi8((char)0xD7);
+	for (; i + 16 <= w; i += 16) {
+		const uint mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(cache + i)), uncached));
+		if (mask != 0) return i + std::countr_zero(mask);
+	}
+#endif
+	for (; i < w; i++) {
+		if (cache[i] == 0xD7) return i;
+	}
+	return w;
+}
+
+/**
+ * Compute the colours of the pixels of a line of the viewport map which are not in the land pixel cache.
+ * @param vp The viewport.
+ * @param cache Start of the line in the land pixel cache.
+ * @param w Width of the line.
+ * @param c Virtual x coordinate of the first pixel.
+ * @param d Virtual y coordinate of the first pixel.
+ * @param incr_a Increment of the virtual coordinates per pixel.
+ * @param colour_index Colour index of the first pixel.
+ * @param bridges Bridge tiles found while computing the colours.
+ * @return Whether any pixel was computed.
+ */
+template <bool is_32bpp, bool show_slope, typename T>
+static bool ViewportMapDrawLine(const Viewport * const vp, T * const cache, const int w, const int c, const int d, const int incr_a, const uint colour_index, ViewportMapBridgeTiles &bridges)
+{
+	bool updated = false;
+	for (int i = ViewportMapFindUncachedPixel(cache, 0, w); i < w; i = ViewportMapFindUncachedPixel(cache, i + 1, w)) {
+		cache[i] = static_cast<T>(ViewportMapGetColour<is_32bpp, show_slope>(vp, c - (i * incr_a), d + (i * incr_a), (colour_index + i) & 3, bridges));
+		updated = true;
+	}
+	return updated;
+}
+
+/** Number of lines of the viewport map which are computed together. */
+static const int VIEWPORT_MAP_LINES_PER_BATCH = 16;
+
 /** Draw the map on a viewport. */
 template <bool is_32bpp, bool show_slope>
 void ViewportMapDraw(Viewport * const vp)
@@ -3710,54 +3826,55 @@ void ViewportMapDraw(Viewport * const vp)
 	const  int sx = UnScaleByZoomLower(_vdd->dpi.left, _vdd->dpi.zoom);
 	const  int sy = UnScaleByZoomLower(_vdd->dpi.top, _vdd->dpi.zoom);
 	const uint line_padding = 2 * (sy & 1);
-	uint       colour_index_base = (sx + line_padding) & 3;
+	const uint colour_index_base = (sx + line_padding) & 3;
 
 	const  int incr_a = (1 << (vp->zoom - 2)) / ZOOM_LVL_BASE;
 	const  int incr_b = (1 << (vp->zoom - 1)) / ZOOM_LVL_BASE;
 	const  int a = (_vdd->dpi.left >> 2) / ZOOM_LVL_BASE;
-	int        b = (_vdd->dpi.top >> 1) / ZOOM_LVL_BASE;
+	const  int b = (_vdd->dpi.top >> 1) / ZOOM_LVL_BASE;
 	const  int w = UnScaleByZoom(_vdd->dpi.width, vp->zoom);
 	const  int h = UnScaleByZoom(_vdd->dpi.height, vp->zoom);
-	int        j = 0;
 
+	using LandCacheType = std::conditional_t<is_32bpp, uint32_t, uint8_t>;
 	const int land_cache_start = _vdd->offset_x + (_vdd->offset_y * vp->width);
-	uint32_t *land_cache_ptr32 = reinterpret_cast<uint32_t *>(vp->land_pixel_cache.data()) + land_cache_start;
-	uint8_t *land_cache_ptr8 = reinterpret_cast<uint8_t *>(vp->land_pixel_cache.data()) + land_cache_start;
+	LandCacheType * const land_cache_ptr = reinterpret_cast<LandCacheType *>(vp->land_pixel_cache.data()) + land_cache_start;
+
+	/* Render base map.
+	 * The colours of the pixels missing from the land pixel cache are computed in batches of lines, which are independent
+	 * of each other, so that large redraws such as when zoomed far out can be spread over the worker threads.
+	 * The bridges found are stored afterwards in the same order as they would be when computing the lines one by one. */
+	const uint batch_count = CeilDiv(h, VIEWPORT_MAP_LINES_PER_BATCH);
+	static std::vector<ViewportMapBridgeTiles> batch_bridges;
+	static std::vector<uint8_t> batch_updated;
+	if (batch_bridges.size() < batch_count) batch_bridges.resize(batch_count);
+	batch_updated.assign(batch_count, 0);
+
+	auto render_batch = [&](uint batch) {
+		ViewportMapBridgeTiles &bridges = batch_bridges[batch];
+		bridges.clear();
+		bool updated = false;
+		const int last = std::min<int>(h, (batch + 1) * VIEWPORT_MAP_LINES_PER_BATCH);
+		for (int j = batch * VIEWPORT_MAP_LINES_PER_BATCH; j < last; j++) {
+			const int line_b = b + (j * incr_b);
+			const uint colour_index = colour_index_base ^ ((j & 1) << 1);
+			if (ViewportMapDrawLine<is_32bpp, show_slope>(vp, land_cache_ptr + (j * vp->width), w, line_b - a, line_b + a, incr_a, colour_index, bridges)) updated = true;
+		}
+		batch_updated[batch] = updated;
+	};
+	if (batch_count > 1 && !HasBit(_viewport_debug_flags, VDF_DISABLE_THREAD)) {
+		_general_worker_pool.ParallelFor(batch_count, render_batch);
+	} else {
+		for (uint batch = 0; batch < batch_count; batch++) {
+			render_batch(batch);
+		}
+	}
 
 	bool cache_updated = false;
-
-	/* Render base map. */
-	do { // For each line
-		int i = w;
-		uint colour_index = colour_index_base;
-		colour_index_base ^= 2;
-		int c = b - a;
-		int d = b + a;
-		do { // For each pixel of a line
-			if (is_32bpp) {
-				if (*land_cache_ptr32 == 0xD7D7D7D7) {
-					*land_cache_ptr32 = ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
-				}
-				land_cache_ptr32++;
-			} else {
-				if (*land_cache_ptr8 == 0xD7) {
-					*land_cache_ptr8 = (uint8_t) ViewportMapGetColour<is_32bpp, show_slope>(vp, c, d, colour_index);
-					cache_updated = true;
-				}
-				land_cache_ptr8++;
-			}
-			colour_index = (colour_index + 1) & 3;
-			c -= incr_a;
-			d += incr_a;
-		} while (--i);
-		if (is_32bpp) {
-			land_cache_ptr32 += (vp->width - w);
-		} else {
-			land_cache_ptr8 += (vp->width - w);
-		}
-		b += incr_b;
-	} while (++j < h);
+	for (uint batch = 0; batch < batch_count; batch++) {
+		if (batch_updated[batch] == 0) continue;
+		cache_updated = true;
+		ViewportMapStoreBridgeTiles(vp, batch_bridges[batch]);
+	}
 
 	auto draw_tunnels = [&](const int y_intercept_min, const int y_intercept_max, const TunnelToMapStorage &storage) {
 		auto iter = std::lower_bound(storage.tunnels.begin(), storage.tunnels.end(), y_intercept_min, [](const TunnelToMap &a, int b) -> bool {
@@ -3851,7 +3968,6 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ParentSpriteToSortVector psts;
 			for (ParentSpriteToDraw *psd : data->psts) {
-				psd->SetComparisonDone(false);
 				if (psd->top + psd->height > data->dpi.top) {
 					psts.push_back(psd);
 				}
@@ -3879,7 +3995,6 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ParentSpriteToSortVector psts;
 			for (ParentSpriteToDraw *psd : data->psts) {
-				psd->SetComparisonDone(false);
 				if (psd->left + psd->width > data->dpi.left - margin) {
 					psts.push_back(psd);
 				}
@@ -3888,11 +4003,29 @@ static void ViewportProcessParentSprites(ViewportDrawerDynamic *vdd, uint data_i
 
 			ViewportProcessParentSprites(vdd, data_index);
 		}
-	} else {
-		_vp_sprite_sorter(&data->psts);
 	}
 }
 
+/* This is run in a worker thread */
+static void ViewportSortParentSpriteSet(ViewportDrawerDynamic *vdd, uint data_index)
+{
+	TimingMeasurement start = GetPerformanceTimer();
+
+	ViewportProcessParentSpritesData *data = &vdd->parent_sprite_sets[data_index];
+	if (vdd->parent_sprite_sets.size() > 1) {
+		/* Sprites near the split lines are in more than one set, and the sorter modifies the sprites it sorts.
+		 * Sort set-local copies, so that all sets can be sorted concurrently. */
+		data->sprites.clear();
+		data->sprites.reserve(data->psts.size());
+		for (ParentSpriteToDraw *&psd : data->psts) {
+			psd = &data->sprites.emplace_back(*psd);
+		}
+	}
+	_vp_sprite_sorter(&data->psts);
+
+	vdd->sort_time.fetch_add(GetPerformanceTimer() - start, std::memory_order_relaxed);
+}
+
 static void ViewportDoDrawPhase2(Viewport *vp, ViewportDrawerDynamic *vdd);
 static void ViewportDoDrawPhase3(Viewport *vp);
 static void ViewportDoDrawRenderJob(Viewport *vp, ViewportDrawerDynamic *vdd);
@@ -4003,17 +4136,21 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom, uint
 		ViewportDoDrawPhase3(vp);
 	} else {
 		/* Classic rendering. */
-		ViewportAddLandscape();
-		ViewportAddVehicles(&_vdd->dpi, vp->update_vehicles);
+		{
+			PerformanceAccumulator collect_framerate(PFE_DRAWWORLD_COLLECT);
 
-		for (const TileSpriteToDraw &ts : _vdd->tile_sprites_to_draw) {
-			PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, ts.image, ts.pal);
-		}
-		for (const ParentSpriteToDraw &ps : _vdd->parent_sprites_to_draw) {
-			if (ps.image != SPR_EMPTY_BOUNDING_BOX) PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, ps.image, ps.pal);
-		}
-		for (const ChildScreenSpriteToDraw &cs : _vdd->child_screen_sprites_to_draw) {
-			PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, cs.image, cs.pal);
+			ViewportAddLandscape();
+			ViewportAddVehicles(&_vdd->dpi, vp->update_vehicles);
+
+			for (const TileSpriteToDraw &ts : _vdd->tile_sprites_to_draw) {
+				PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, ts.image, ts.pal);
+			}
+			for (const ParentSpriteToDraw &ps : _vdd->parent_sprites_to_draw) {
+				if (ps.image != SPR_EMPTY_BOUNDING_BOX) PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, ps.image, ps.pal);
+			}
+			for (const ChildScreenSpriteToDraw &cs : _vdd->child_screen_sprites_to_draw) {
+				PrepareDrawSpriteViewportSpriteStore(_vdd->sprite_data, &_vdd->dpi, cs.image, cs.pal);
+			}
 		}
 
 		_viewport_drawer_jobs++;
@@ -4030,6 +4167,7 @@ void ViewportDoDraw(Viewport *vp, int left, int top, int right, int bottom, uint
 
 /* This is run in a worker thread */
 static void ViewportDoDrawRenderSubJob(Viewport *vp, ViewportDrawerDynamic *vdd, uint data_index) {
+	ViewportSortParentSpriteSet(vdd, data_index);
 	ViewportDrawParentSprites(vdd, &vdd->parent_sprite_sets[data_index].dpi, &vdd->parent_sprite_sets[data_index].psts, &vdd->child_screen_sprites_to_draw);
 
 	if (_draw_dirty_blocks && HasBit(_viewport_debug_flags, VDF_DIRTY_BLOCK_PER_SPLIT)) {
@@ -4069,8 +4207,11 @@ static void ViewportDoDrawRenderJob(Viewport *vp, ViewportDrawerDynamic *vdd)
 	}
 	vdd->parent_sprite_sets[0].dpi = vdd->dpi;
 
+	/* Split the drawing region, each resulting set is then sorted and drawn by its own sub job */
 	ViewportProcessParentSprites(vdd, 0);
 
+	vdd->sort_time.store(0, std::memory_order_relaxed);
+
 	vdd->draw_jobs_active.store((uint)vdd->parent_sprite_sets.size(), std::memory_order_relaxed);
 
 	for (uint i = 1; i < (uint)vdd->parent_sprite_sets.size(); i++) {
@@ -4103,6 +4244,8 @@ void ViewportDoDrawProcessAllPending()
 			_viewport_drawer_returns.pop_back();
 			lk.unlock();
 
+			PerformanceAccumulator::AddTime(PFE_DRAWWORLD_SORT, _vdd->sort_time.load(std::memory_order_relaxed));
+
 			{
 				AutoRestoreBackup dpi_backup(_cur_dpi, AutoRestoreBackupNoNewValueTag{});
 				ViewportDoDrawPhase3(vp);
@@ -4599,6 +4742,8 @@ void MarkAllViewportMapsDirty(int left, int top, int right, int bottom)
 
 void MarkAllViewportMapLandscapesDirty()
 {
+	ClearSmallMapTileColourCache();
+	MarkAllMapTileExportDirty();
 	for (Window *w : Window::Iterate()) {
 		Viewport *vp = w->viewport;
 		if (vp != nullptr && vp->zoom >= ZOOM_LVL_DRAW_MAP) {
@@ -4655,6 +4800,10 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags, int bridge_level_offset, int tile_height_override)
 {
+	if (!(flags & (VMDF_NOT_MAP_MODE | VMDF_NOT_LANDSCAPE))) {
+		MarkSmallMapTileDirty(tile);
+		MarkMapTileExportDirty(tile);
+	}
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
 	MarkAllViewportsDirty(
 			pt.x - 31  * ZOOM_LVL_BASE,
@@ -4667,6 +4816,10 @@ void MarkTileDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags, int bridg
 
 void MarkTileGroundDirtyByTile(TileIndex tile, ViewportMarkDirtyFlags flags)
 {
+	if (!(flags & (VMDF_NOT_MAP_MODE | VMDF_NOT_LANDSCAPE))) {
+		MarkSmallMapTileDirty(tile);
+		MarkMapTileExportDirty(tile);
+	}
 	int x = TileX(tile) * TILE_SIZE;
 	int y = TileY(tile) * TILE_SIZE;
 	Point top = RemapCoords(x, y, GetTileMaxPixelZ(tile));
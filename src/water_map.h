@@ -514,6 +514,7 @@ inline void SetNonFloodingWaterTile(TileIndex t, bool b)
 {
 	dbg_assert(IsTileType(t, MP_WATER));
 	SB(_m[t].m3, 0, 1, b ? 1 : 0);
+	WakeTileLoopTile(t);
 }
 /**
  * Checks whether the tile is marked as a non-flooding water tile.
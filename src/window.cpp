@@ -901,6 +901,8 @@ void DrawOverlappedWindow(Window *w, int left, int top, int right, int bottom, D
 	dp->dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_screen.dst_ptr, left, top);
 	dp->zoom = ZOOM_LVL_NORMAL;
 	w->OnPaint();
+	_redraw_stats.current.window_paints++;
+	_redraw_stats.current.window_pixels += (uint64_t)(right - left) * (bottom - top);
 	if (unlikely(flags & DOWF_SHOW_DEBUG)) {
 		if (w->viewport != nullptr) ViewportDoDrawProcessAllPending();
 		extern void ViewportDrawDirtyBlocks(const DrawPixelInfo *dpi, bool increment_colour);
@@ -3265,6 +3267,8 @@ void UpdateWindows()
 
 	PerformanceMeasurer framerate(PFE_DRAWING);
 	PerformanceAccumulator::Reset(PFE_DRAWWORLD);
+	PerformanceAccumulator::Reset(PFE_DRAWWORLD_COLLECT);
+	PerformanceAccumulator::Reset(PFE_DRAWWORLD_SORT);
 
 	ProcessPendingPerformanceMeasurements();
 
@@ -11,6 +11,9 @@
 #include "worker_thread.h"
 #include "thread.h"
 
+#include <atomic>
+#include <memory>
+
 #include "safeguards.h"
 
 WorkerThreadPool _general_worker_pool;
@@ -61,6 +64,79 @@ void WorkerThreadPool::EnqueueJob(WorkerJobFunc *func, void *data1, void *data2,
 	if (notify) this->worker_wait_cv.notify_one();
 }
 
+/**
+ * Shared state of a WorkerThreadPool::ParallelFor call.
+ * Helper jobs share the ownership, so a helper which only starts after all items are done can still find that out.
+ */
+struct WorkerParallelForState {
+	WorkerParallelForFunc *func;
+	void *data;
+	uint count;
+	std::atomic<uint> next_index = 0;
+	std::mutex lock;
+	std::condition_variable done_cv;
+	uint items_done = 0;
+
+	void RunItems()
+	{
+		uint done = 0;
+		while (true) {
+			uint index = this->next_index.fetch_add(1, std::memory_order_relaxed);
+			if (index >= this->count) break;
+			this->func(this->data, index);
+			done++;
+		}
+		if (done == 0) return;
+
+		std::lock_guard<std::mutex> lk(this->lock);
+		this->items_done += done;
+		if (this->items_done == this->count) this->done_cv.notify_one();
+	}
+};
+
+/**
+ * Call func(data, i) for each i in [0, count), distributed over the worker threads and the calling thread.
+ * This returns when all calls have completed. It does not wait for helper jobs which did not start yet,
+ * e.g. because the workers are busy with long jobs, the calling thread does their items instead.
+ * This must not be called from a job running in this pool.
+ * @param count Number of items.
+ * @param func Function to call for each item, this must be safe to call concurrently.
+ * @param data Data to pass to func.
+ */
+void WorkerThreadPool::ParallelFor(uint count, WorkerParallelForFunc *func, void *data)
+{
+	if (count == 0) return;
+
+	std::unique_lock<std::mutex> lk(this->lock);
+	uint helpers = std::min<uint>(this->workers, count - 1);
+	lk.unlock();
+
+	if (helpers == 0) {
+		for (uint i = 0; i < count; i++) {
+			func(data, i);
+		}
+		return;
+	}
+
+	std::shared_ptr<WorkerParallelForState> state = std::make_shared<WorkerParallelForState>();
+	state->func = func;
+	state->data = data;
+	state->count = count;
+
+	for (uint i = 0; i < helpers; i++) {
+		this->EnqueueJob([](void *data1, void *, void *) {
+			std::unique_ptr<std::shared_ptr<WorkerParallelForState>> state(static_cast<std::shared_ptr<WorkerParallelForState> *>(data1));
+			(*state)->RunItems();
+		}, new std::shared_ptr<WorkerParallelForState>(state));
+	}
+
+	state->RunItems();
+
+	/* Only wait for the items other threads are still running, helper jobs which start later find nothing left to do. */
+	std::unique_lock<std::mutex> state_lk(state->lock);
+	state->done_cv.wait(state_lk, [&]() { return state->items_done == state->count; });
+}
+
 void WorkerThreadPool::Run(WorkerThreadPool *pool)
 {
 	std::unique_lock<std::mutex> lk(pool->lock);
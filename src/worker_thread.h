@@ -15,6 +15,7 @@
 #include <condition_variable>
 
 typedef void WorkerJobFunc(void *, void *, void *);
+typedef void WorkerParallelForFunc(void *, uint);
 
 struct WorkerThreadPool {
 private:
@@ -40,6 +41,22 @@ public:
 	void Start(const char *thread_name, uint max_workers);
 	void Stop();
 	void EnqueueJob(WorkerJobFunc *func, void *data1 = nullptr, void *data2 = nullptr, void *data3 = nullptr);
+	void ParallelFor(uint count, WorkerParallelForFunc *func, void *data);
+
+	/**
+	 * Call func(i) for each i in [0, count), distributed over the worker threads and the calling thread.
+	 * This returns when all calls have completed, without waiting for helper jobs queued behind other jobs.
+	 * This must not be called from a job running in this pool.
+	 * @param count Number of items.
+	 * @param func Function to call for each item, this must be safe to call concurrently.
+	 */
+	template <typename F>
+	void ParallelFor(uint count, F func)
+	{
+		this->ParallelFor(count, [](void *data, uint index) {
+			(*static_cast<F *>(data))(index);
+		}, &func);
+	}
 
 	~WorkerThreadPool()
 	{
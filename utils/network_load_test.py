@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+
+# This file is part of OpenTTD.
+# OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+# OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+# See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Load generator for a local dedicated server.
+
+Joins a number of spectator clients to the server, downloads the map with each of them, and then measures how the
+frame packets of the server arrive at the clients:
+ - the frame spread: the time between the first and the last client receiving the same frame,
+ - the frame interval: the time between two consecutive frames at the same client.
+
+The revision and NewGRF version of the server have to match exactly; they are taken from the [version] section of
+the openttd.cfg written by the server binary (--config), or can be given with --revision and --newgrf-version.
+Servers with a game password are not supported.
+
+Example:
+    ./openttd -D -c /tmp/server.cfg &
+    utils/network_load_test.py --config /tmp/server.cfg --clients 100 --duration 60
+"""
+
+import argparse
+import configparser
+import selectors
+import socket
+import struct
+import sys
+import time
+
+PACKET_SERVER_FULL = 0
+PACKET_SERVER_BANNED = 1
+PACKET_CLIENT_JOIN = 2
+PACKET_SERVER_ERROR = 3
+PACKET_SERVER_CHECK_NEWGRFS = 9
+PACKET_CLIENT_NEWGRFS_CHECKED = 10
+PACKET_SERVER_NEED_GAME_PASSWORD = 11
+PACKET_SERVER_NEED_COMPANY_PASSWORD = 13
+PACKET_SERVER_WELCOME = 17
+PACKET_CLIENT_GETMAP = 19
+PACKET_SERVER_MAP_BEGIN = 21
+PACKET_SERVER_MAP_DONE = 24
+PACKET_CLIENT_MAP_OK = 25
+PACKET_SERVER_FRAME = 27
+PACKET_CLIENT_ACK = 28
+
+COMPANY_SPECTATOR = 255
+DAY_TICKS = 74
+
+
+def make_packet(packet_type, payload=b""):
+    return struct.pack("<HB", len(payload) + 3, packet_type) + payload
+
+
+def pack_string(value):
+    return value.encode("utf-8") + b"\0"
+
+
+class LoadClient:
+    """A single spectator client, doing just enough of the protocol to stay connected."""
+
+    def __init__(self, index, args):
+        self.index = index
+        self.args = args
+        self.sock = socket.create_connection((args.host, args.port))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock.setblocking(False)
+        self.recv_buffer = bytearray()
+        self.send_buffer = bytearray()
+        self.active = False
+        self.closed = False
+        self.token = 0
+        self.next_ack_frame = 0
+        self.last_frame_time = None
+        self.intervals = []
+
+        self.send(make_packet(PACKET_CLIENT_JOIN, pack_string(args.revision) + struct.pack("<I", args.newgrf_version) +
+                pack_string("load%d" % index) + struct.pack("<BB", COMPANY_SPECTATOR, 0)))
+
+    def send(self, data):
+        self.send_buffer += data
+        self.flush()
+
+    def flush(self):
+        try:
+            while self.send_buffer:
+                sent = self.sock.send(self.send_buffer)
+                del self.send_buffer[:sent]
+        except BlockingIOError:
+            pass
+
+    def close(self, reason):
+        if self.closed:
+            return
+        print("client %d: %s" % (self.index, reason), file=sys.stderr)
+        self.closed = True
+        self.sock.close()
+
+    def receive(self, now, frames):
+        """Read everything available and handle the complete packets."""
+        try:
+            while True:
+                data = self.sock.recv(65536)
+                if not data:
+                    self.close("connection closed by server")
+                    return
+                self.recv_buffer += data
+        except BlockingIOError:
+            pass
+        except ConnectionError as e:
+            self.close(str(e))
+            return
+
+        while len(self.recv_buffer) >= 3:
+            size, packet_type = struct.unpack_from("<HB", self.recv_buffer)
+            if len(self.recv_buffer) < size:
+                break
+            payload = bytes(self.recv_buffer[3:size])
+            del self.recv_buffer[:size]
+            self.handle_packet(packet_type, payload, now, frames)
+            if self.closed:
+                return
+
+    def handle_packet(self, packet_type, payload, now, frames):
+        if packet_type in (PACKET_SERVER_FULL, PACKET_SERVER_BANNED):
+            self.close("refused by server (full or banned)")
+        elif packet_type == PACKET_SERVER_ERROR:
+            self.close("server error %d" % payload[0])
+        elif packet_type in (PACKET_SERVER_NEED_GAME_PASSWORD, PACKET_SERVER_NEED_COMPANY_PASSWORD):
+            self.close("server requires a password, which is not supported")
+        elif packet_type == PACKET_SERVER_CHECK_NEWGRFS:
+            self.send(make_packet(PACKET_CLIENT_NEWGRFS_CHECKED))
+        elif packet_type == PACKET_SERVER_WELCOME:
+            self.send(make_packet(PACKET_CLIENT_GETMAP, struct.pack("<B", 0))) # no zstd support
+        elif packet_type == PACKET_SERVER_MAP_BEGIN:
+            print("client %d: receiving map" % self.index, file=sys.stderr)
+        elif packet_type == PACKET_SERVER_MAP_DONE:
+            self.send(make_packet(PACKET_CLIENT_MAP_OK))
+            self.active = True
+        elif packet_type == PACKET_SERVER_FRAME and self.active:
+            frame, = struct.unpack_from("<I", payload)
+            if len(payload) >= 9:
+                self.token = payload[8]
+            if self.last_frame_time is not None:
+                self.intervals.append(now - self.last_frame_time)
+            self.last_frame_time = now
+            frames.setdefault(frame, []).append(now)
+
+            # Acknowledge like the real client, once per day, but include a new token straight away.
+            if frame >= self.next_ack_frame or len(payload) >= 9:
+                self.next_ack_frame = frame + DAY_TICKS
+                self.send(make_packet(PACKET_CLIENT_ACK, struct.pack("<IB", frame, self.token)))
+
+
+def percentiles(values, points=(50, 90, 99, 100)):
+    if not values:
+        return "no samples"
+    values = sorted(values)
+    parts = []
+    for point in points:
+        index = min(len(values) - 1, (len(values) * point) // 100)
+        parts.append("p%d %.2f ms" % (point, values[index] * 1000))
+    return ", ".join(parts)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Simulate many clients on a local server and measure frame send latency.")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=3979)
+    parser.add_argument("--clients", type=int, default=50, help="number of clients to connect")
+    parser.add_argument("--duration", type=float, default=30, help="seconds to measure after all clients joined")
+    parser.add_argument("--config", help="openttd.cfg of the server, to read the version from")
+    parser.add_argument("--revision", help="revision string of the server")
+    parser.add_argument("--newgrf-version", type=lambda x: int(x, 16), help="NewGRF version of the server, in hex")
+    args = parser.parse_args()
+
+    if args.config is not None:
+        cfg = configparser.ConfigParser(interpolation=None, strict=False)
+        cfg.read(args.config)
+        if args.revision is None:
+            args.revision = cfg.get("version", "version_string")
+        if args.newgrf_version is None:
+            args.newgrf_version = int(cfg.get("version", "version_number"), 16)
+    if args.revision is None or args.newgrf_version is None:
+        parser.error("the server version is needed, use --config or --revision and --newgrf-version")
+
+    sel = selectors.DefaultSelector()
+    clients = []
+    for i in range(args.clients):
+        client = LoadClient(i, args)
+        clients.append(client)
+        sel.register(client.sock, selectors.EVENT_READ, client)
+
+    frames = {}
+    start = time.monotonic()
+    measure_start = None
+    while True:
+        now = time.monotonic()
+        live = [c for c in clients if not c.closed]
+        if not live:
+            print("all clients disconnected", file=sys.stderr)
+            return 1
+        if measure_start is None and all(c.active for c in live):
+            print("%d clients joined after %.1f s, measuring" % (len(live), now - start), file=sys.stderr)
+            measure_start = now
+            frames.clear()
+            for c in live:
+                c.intervals.clear()
+                c.last_frame_time = None
+        if measure_start is not None and now - measure_start >= args.duration:
+            break
+
+        for key, _ in sel.select(timeout=0.1):
+            client = key.data
+            client.receive(time.monotonic(), frames)
+            if client.closed:
+                sel.unregister(key.fileobj)
+        for c in live:
+            if c.send_buffer and not c.closed:
+                c.flush()
+
+    live = [c for c in clients if not c.closed]
+    complete = [times for times in frames.values() if len(times) == len(live)]
+    spreads = [max(times) - min(times) for times in complete]
+    intervals = [interval for c in live for interval in c.intervals]
+    print("clients: %d, frames: %d" % (len(live), len(complete)))
+    print("frame spread over clients: %s" % percentiles(spreads))
+    print("frame interval per client: %s" % percentiles(intervals))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())